@@ -3,23 +3,21 @@
 #include "xtmrctr_l.h"
 #include "xil_printf.h"
 #include "mb_interface.h"
+#include "fsm_engine.h"
+#include "isr_prof.h"
+#include "isr_budget.h"
+#include "app_core.h"
 
 // --- MAPPATURA INDIRIZZI HARDWARE ---
 // Questi puntatori collegano il codice C ai pin fisici della scheda (GPIO)
-volatile int *LED_DATA = (volatile int *)0x40000000; // Registro per scrivere sui LED
-volatile int *LED_TRI  = (volatile int *)0x40000004; // Registro per configurare LED (In/Out)
+static volatile int *LED_DATA = (volatile int *)0x40000000; // Registro per scrivere sui LED
+static volatile int *LED_TRI  = (volatile int *)0x40000004; // Registro per configurare LED (In/Out)
 
-volatile int *BTN_LEFT_DATA = (volatile int *)0x40060000; // Dati pulsante Sinistro
-volatile int *BTN_LEFT_TRI  = (volatile int *)0x40060004; // Configurazione pulsante Sinistro
+static volatile int *BTN_LEFT_DATA = (volatile int *)0x40060000; // Dati pulsante Sinistro
+static volatile int *BTN_LEFT_TRI  = (volatile int *)0x40060004; // Configurazione pulsante Sinistro
 
-volatile int *BTN_RIGHT_DATA = (volatile int *)0x40050000; // Dati pulsante Destro
-volatile int *BTN_RIGHT_TRI  = (volatile int *)0x40050004; // Configurazione pulsante Destro
-
-// --- REGISTRI INTERRUZIONI (Interrupt Controller) ---
-volatile int *IER  = (volatile int *)0x41200008; // Interrupt Enable Register
-volatile int *MER  = (volatile int *)0x4120001C; // Master Enable Register
-volatile int *IISR = (volatile int *)0x41200000; // Interrupt Status Register
-volatile int *IIAR = (volatile int *)0x4120000C; // Interrupt Acknowledge Register
+static volatile int *BTN_RIGHT_DATA = (volatile int *)0x40050000; // Dati pulsante Destro
+static volatile int *BTN_RIGHT_TRI  = (volatile int *)0x40050004; // Configurazione pulsante Destro
 
 // --- COSTANTI DEL TIMER ---
 #ifndef TMRCTR_BASEADDR
@@ -30,106 +28,132 @@ volatile int *IIAR = (volatile int *)0x4120000C; // Interrupt Acknowledge Regist
 #define TIMER_RESET_VALUE 50000000 
 
 // Variabile globale che cambia valore (0 o 1) ogni volta che il timer scatta (usata per il lampeggio)
-volatile int blink_state = 0;
+static volatile int blink_state = 0;
+
+// Misura dei cicli della ISR (attiva solo con ISR_PROFILE)
+static isr_prof_t prof_isr = ISR_PROF_INIT;
 
 // Stati per la gestione del click del pulsante
 typedef enum { STATE_IDLE, STATE_PRESSED} debounce_state_t;
 // Stati del sistema "Frecce Auto": Centro (spento), Sinistra, Destra
-typedef enum { CAR_CENTER, CAR_LEFT, CAR_RIGHT } car_state_t;
+typedef enum { CAR_CENTER, CAR_LEFT, CAR_RIGHT, CAR_N_STATES } car_state_t;
+// Eventi che fanno avanzare la macchina: click dei pulsanti e tick del lampeggio
+typedef enum { EV_BTN_LEFT, EV_BTN_RIGHT, EV_BLINK, CAR_N_EVENTS } car_event_t;
 
 // Prototipi delle funzioni
-void myISR(void) __attribute__((interrupt_handler)); // Funzione chiamata dall'hardware in automatico
-int SetupTimer(void);
-int FSM_Debounce(volatile int *port_address, debounce_state_t *current_state);
+static int FsmInit(void);
+static void FsmStep(void);
+static void FsmISR(u32 p);  // Chiamata dalla myISR del nucleo in automatico
+static void FsmStop(void);
+static int SetupTimer(void);
+static int FSM_Debounce(volatile int *port_address, debounce_state_t *current_state);
+
+// Le frecce come modulo del nucleo (app_core.h)
+const app_module_t app_fsm = { "frecce", FsmInit, FsmStep, FsmISR, NULL, FsmStop };
+
+// --- AZIONI DELLA MACCHINA A STATI ---
+static void LedsOff(void *ctx)     { *LED_DATA = 0x0; }
+// Freccia SX sul bit 1 (0x2), freccia DX sul bit 0 (0x1), a seconda del lampeggio
+static void ShowLeft(void *ctx)    { *LED_DATA = blink_state ? 0x2 : 0x0; }
+static void ShowRight(void *ctx)   { *LED_DATA = blink_state ? 0x1 : 0x0; }
+static void PrintLeft(void *ctx)   { xil_printf("Azione: FRECCIA SX\r\n"); }
+static void PrintRight(void *ctx)  { xil_printf("Azione: FRECCIA DX\r\n"); }
+static void PrintOff(void *ctx)    { xil_printf("Azione: OFF\r\n"); }
+
+// Tabella delle transizioni (le voci mancanti = evento ignorato)
+static const fsm_transition_t car_table[CAR_N_STATES][CAR_N_EVENTS] = {
+    // CASO 1: Nessuna freccia attiva
+    [CAR_CENTER][EV_BTN_LEFT]  = FSM_GOTO(CAR_LEFT,   PrintLeft),
+    [CAR_CENTER][EV_BTN_RIGHT] = FSM_GOTO(CAR_RIGHT,  PrintRight),
+    // CASO 2: Freccia Sinistra attiva (se premo di nuovo sinistra torno al centro)
+    [CAR_LEFT][EV_BTN_LEFT]    = FSM_GOTO(CAR_CENTER, PrintOff),
+    [CAR_LEFT][EV_BLINK]       = FSM_DO(ShowLeft),
+    // CASO 3: Freccia Destra attiva (se premo di nuovo destra torno al centro)
+    [CAR_RIGHT][EV_BTN_RIGHT]  = FSM_GOTO(CAR_CENTER, PrintOff),
+    [CAR_RIGHT][EV_BLINK]      = FSM_DO(ShowRight),
+};
+
+// All'ingresso di ogni stato i LED vengono subito portati nello stato giusto
+static const fsm_action_t car_entry[CAR_N_STATES] = {
+    [CAR_CENTER] = LedsOff,
+    [CAR_LEFT]   = ShowLeft,
+    [CAR_RIGHT]  = ShowRight,
+};
+
+static const fsm_def_t car_fsm_def = FSM_DEF(car_table, car_entry, NULL);
+
+// Stato del modulo (prima erano le variabili locali del main)
+static fsm_t carFsm;
+static int last_blink;
+
+// Stati indipendenti per i due pulsanti
+static debounce_state_t dbStateLeft = STATE_IDLE;
+static debounce_state_t dbStateRight = STATE_IDLE;
+
+#ifndef APP_SINGLE_IMAGE
+APP_STANDALONE_MAIN(app_fsm)
+#endif
 
-int main(void)
+static int FsmInit(void)
 {
     int status;
-    car_state_t carState = CAR_CENTER; // Stato iniziale: frecce spente
-
-    // Stati indipendenti per i due pulsanti
-    debounce_state_t dbStateLeft = STATE_IDLE;
-    debounce_state_t dbStateRight = STATE_IDLE;
 
-    int trigger_left = 0;
-    int trigger_right = 0;
+    dbStateLeft = STATE_IDLE;
+    dbStateRight = STATE_IDLE;
 
     // Configurazione GPIO: 0 = Output (LED), 1 = Input (Pulsanti)
     *LED_TRI = 0x0;
-    *LED_DATA = 0x0; // Spegne tutti i LED all'avvio
 
     *BTN_LEFT_TRI = 0xFFFFFFFF;  // Input
     *BTN_RIGHT_TRI = 0xFFFFFFFF; // Input
 
+    // Stato iniziale: frecce spente (l'azione di ingresso spegne i LED)
+    fsm_init(&carFsm, &car_fsm_def, CAR_CENTER, NULL);
+    last_blink = blink_state;
+
     // Configura e avvia il timer hardware
     status = SetupTimer();
     if (status != XST_SUCCESS) {
         xil_printf("Errore Setup Timer\r\n");
         return XST_FAILURE;
     }
+    return XST_SUCCESS;
+}
 
-    // --- CICLO INFINITO (Loop Principale) ---
-    while(1) {
-        // Legge i pulsanti ed elimina i rimbalzi (debounce).
-        // Restituisce 1 solo nell'istante in cui il pulsante viene rilasciato.
-        trigger_left  = FSM_Debounce(BTN_LEFT_DATA, &dbStateLeft);
-        trigger_right = FSM_Debounce(BTN_RIGHT_DATA, &dbStateRight);
-
-        // Macchina a Stati per la logica delle frecce
-        
-        switch (carState) {
-            
-            // CASO 1: Nessuna freccia attiva
-            case CAR_CENTER:
-                *LED_DATA = 0x0; // Tutto spento
-
-                if (trigger_left) {
-                    carState = CAR_LEFT; // Passa allo stato Sinistra
-                    xil_printf("Azione: FRECCIA SX\r\n");
-                } else if (trigger_right) {
-                    carState = CAR_RIGHT; // Passa allo stato Destra
-                    xil_printf("Azione: FRECCIA DX\r\n");
-                }
-                break;
-
-            // CASO 2: Freccia Sinistra attiva
-            case CAR_LEFT:
-                // Se premo di nuovo sinistra, spengo tutto (torno al centro)
-                if (trigger_left) {
-                    carState = CAR_CENTER;
-                    xil_printf("Azione: OFF\r\n");
-                    *LED_DATA = 0x0;
-                }
-                else {
-                    // Gestione lampeggio: se blink_state è 1 accendo il bit 1 (0x2), altrimenti spengo
-                    if (blink_state) *LED_DATA = 0x2; 
-                    else             *LED_DATA = 0x0;
-                }
-                break;
-
-            // CASO 3: Freccia Destra attiva
-            case CAR_RIGHT:
-                // Se premo di nuovo destra, spengo tutto (torno al centro)
-                if (trigger_right) {
-                    carState = CAR_CENTER;
-                    xil_printf("Azione: OFF\r\n");
-                    *LED_DATA = 0x0;
-                }
-                else {
-                    // Gestione lampeggio: se blink_state è 1 accendo il bit 0 (0x1), altrimenti spengo
-                    if (blink_state) *LED_DATA = 0x1;
-                    else             *LED_DATA = 0x0;
-                }
-                break;
-        }
+// --- UN GIRO DEL LOOP PRINCIPALE ---
+static void FsmStep(void)
+{
+    // Legge i pulsanti ed elimina i rimbalzi (debounce).
+    // Restituisce 1 solo nell'istante in cui il pulsante viene rilasciato.
+    int trigger_left  = FSM_Debounce(BTN_LEFT_DATA, &dbStateLeft);
+    int trigger_right = FSM_Debounce(BTN_RIGHT_DATA, &dbStateRight);
+
+    // La macchina a stati gira solo quando c'è un evento.
+    // Se entrambi i pulsanti scattano insieme vince il sinistro,
+    // a meno che lo stato attuale non lo ignori.
+    if (!(trigger_left && fsm_dispatch(&carFsm, EV_BTN_LEFT)) && trigger_right)
+        fsm_dispatch(&carFsm, EV_BTN_RIGHT);
+
+    // Il timer ha cambiato lo stato del lampeggio
+    if (blink_state != last_blink) {
+        last_blink = blink_state;
+        fsm_dispatch(&carFsm, EV_BLINK);
     }
-    return 0;
+
+    ISR_PROF_CHECK("FSM myISR", prof_isr, ISR_BUDGET_FSM);
+}
+
+// --- ARRESTO: timer fermo e frecce spente ---
+static void FsmStop(void)
+{
+    app_core_timer_stop(TMRCTR_BASEADDR, TIMER_COUNTER_0);
+    *LED_DATA = 0x0;
 }
 
 // --- FUNZIONE DEBOUNCE (Antirimbalzo) ---
 // Serve a leggere il pulsante in modo pulito. 
 // Restituisce 1 (trigger) solo quando il pulsante viene RILASCIATO.
-int FSM_Debounce(volatile int *port_address, debounce_state_t *state) {
+static int FSM_Debounce(volatile int *port_address, debounce_state_t *state) {
     int button_val = (*port_address & 0x1); // Legge il bit 0 del registro
     int trigger = 0;
 
@@ -154,11 +178,7 @@ int FSM_Debounce(volatile int *port_address, debounce_state_t *state) {
 }
 
 // --- CONFIGURAZIONE TIMER ---
-int SetupTimer(void) {
-    // Abilita interruzioni globali
-    *IER = XPAR_AXI_TIMER_0_INTERRUPT_MASK;
-    *MER = 0x3;
-
+static int SetupTimer(void) {
     // Imposta il timer: resetta, carica il valore 50.000.000
     XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_COUNTER_0, 0);
     XTmrCtr_SetLoadReg(TMRCTR_BASEADDR, TIMER_COUNTER_0, TIMER_RESET_VALUE);
@@ -170,16 +190,17 @@ int SetupTimer(void) {
 
     XTmrCtr_Enable(TMRCTR_BASEADDR, TIMER_COUNTER_0);
     
-    // Abilita interruzioni sulla CPU MicroBlaze
-    microblaze_enable_interrupts();
+    // Abilita la linea del timer nel controller delle interruzioni
+    app_core_irq_enable(XPAR_AXI_TIMER_0_INTERRUPT_MASK);
 
     return XST_SUCCESS;
 }
 
 // --- GESTORE INTERRUZIONI (ISR) ---
 // Questa funzione viene eseguita ogni volta che il timer arriva a zero (ogni 0.5s circa)
-void myISR(void) {
-    unsigned p = *IISR; // Legge chi ha causato l'interruzione
+// p = chi ha causato l'interruzione (letto dalla myISR del nucleo)
+static void FsmISR(u32 p) {
+    ISR_PROF_BEGIN(t_isr);
 
     if (p & XPAR_AXI_TIMER_0_INTERRUPT_MASK) {
         // Pulisce il flag dell'interruzione hardware (per permettere future interruzioni)
@@ -193,4 +214,6 @@ void myISR(void) {
         // Inverte lo stato del lampeggio (0 -> 1 oppure 1 -> 0)
         blink_state = !blink_state;
     }
+
+    ISR_PROF_END(prof_isr, t_isr);
 }
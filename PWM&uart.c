@@ -3,62 +3,97 @@
 #include "xtmrctr_l.h"
 #include "xil_printf.h"
 #include "xparameters.h"
-#include "xuartlite_l.h"
 #include "xil_io.h"
+#include "timebase.h"
+#include "isr_prof.h"
+#include "isr_budget.h"
+#include "stack_mon.h"
+#include "app_core.h"
+#include "boot.h"
+#include "pwm_cfg.h"
+#include "fixmath.h"
+#include "console.h"
+#include "trace.h"
 
 // Seleziona indirizzi base a seconda della piattaforma
 #ifndef SDT
     #define TMRCTR_BASEADDR		XPAR_TMRCTR_0_BASEADDR
-    #define UART_BASEADDR       XPAR_UARTLITE_0_BASEADDR
 #else
     #define TMRCTR_BASEADDR		XPAR_XTMRCTR_0_BASEADDR
-    #define UART_BASEADDR       XPAR_XUARTLITE_0_BASEADDR
 #endif
 
 #define TIMER_COUNTER_0	 0
-#define NO_DATA          0xFFFFFFFF // Valore per indicare nessun dato ricevuto
 
 // Puntatori diretti ai registri fisici per GPIO (Pulsanti e LED RGB)
-volatile int * gpio_buttons_tri  = (volatile int *)0x40060004; 
-volatile int * gpio_rgb_data     = (volatile int *)0x40000008;
-
-// Puntatori diretti ai registri del controller delle interruzioni (INTC)
-volatile int * IER = (volatile int*)0x41200008; // Abilitazione interrupt
-volatile int * MER = (volatile int*)0x4120001C; // Master Enable
-volatile int * IISR = (volatile int*)0x41200000; // Stato interrupt
-volatile int * IIAR = (volatile int*)0x4120000C; // Acknowledge (conferma)
+static volatile int * gpio_buttons_tri  = (volatile int *)0x40060004; 
+static volatile int * gpio_rgb_data     = (volatile int *)0x40000008;
 
 // Variabili globali per la gestione PWM e colori
-volatile u8 pwm_counter = 0; // Contatore ciclico 0-255
-volatile u32 sys_time = 0;   // Tempo di sistema per debounce
+static pwm_rt_t pwm; // Fase, frequenza e risoluzione del PWM (pwm_cfg.h)
+
+// Duty già corretti in gamma: la ISR confronta e basta
+static volatile u8 duty_R = 0; // Luminosità Rosso
+static volatile u8 duty_G = 0; // Luminosità Verde
+static volatile u8 duty_B = 0; // Luminosità Blu
+static u8 color[3];            // Ultimo colore chiesto, prima della gamma (per "info")
 
-volatile u8 duty_R = 0; // Luminosità Rosso
-volatile u8 duty_G = 0; // Luminosità Verde
-volatile u8 duty_B = 0; // Luminosità Blu
+// Misura dei cicli (attiva solo con ISR_PROFILE), stampate con il comando 'p'
+static isr_prof_t prof_isr = ISR_PROF_INIT;
+static isr_prof_t prof_update = ISR_PROF_INIT;
 
 // Prototipi delle funzioni
-void myISR(void) __attribute__((interrupt_handler)); // Gestore interruzioni
-int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TimerCounter);
-u32 my_XUartLite_RecvByte(UINTPTR BaseAddress);
-void update_leds(u32 data, u8 mode);
+static int RgbInit(void);
+static void RgbStep(void);
+static void RgbISR(u32 p);      // Gestore interruzioni (chiamato dalla myISR del nucleo)
+static void RgbByte(u8 c);
+static void RgbStop(void);
+static int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TimerCounter);
+static void update_leds(u32 data, u8 mode);
+static void set_rgb(u8 r, u8 g, u8 b);
+static void RgbKey(u8 c);
+static int RgbDiag(char c);
+static void CmdRgb(const s32 *argv, u8 argc);
+static void CmdInfo(const s32 *argv, u8 argc);
+static void CmdHz(const s32 *argv, u8 argc);
+
+// Comandi a parole (console.h); i tasti singoli restano quelli di RgbKey,
+// e nessuna parola inizia con uno di loro
+static const console_cmd_t rgb_cmds[] = {
+    { "rgb",  3, 3, CmdRgb,  "rgb R G B (0-255)" },
+    { "info", 0, 0, CmdInfo, "info" },
+    { "hz",   0, 2, CmdHz,   "hz [Hz [bit]]" },
+};
+static console_t con;
 
-int main(void){
-	init_platform();
+// Modulo del nucleo (app_core.h): la seriale la legge il nucleo
+const app_module_t app_rgb = { "rgb-uart", RgbInit, RgbStep, RgbISR, RgbByte, RgbStop };
+
+#ifndef APP_SINGLE_IMAGE
+APP_STANDALONE_MAIN(app_rgb)
+#endif
 
+// Prima init_platform (cache e seriale), come nel programma da solo: una
+// volta sola, così i cambi di modulo successivi non la ripetono. Nel
+// cambio tutte le linee dell'INTC sono spente fino all'accensione del
+// timer qui sotto, quindi nessun interrupt la interrompe.
+static int RgbInit(void){
+	static u8 platform_ready;
 	int Status;
-    u32 uart_input;
-    u32 button_input;
+
+    if (!platform_ready) {
+        init_platform();
+        platform_ready = 1;
+    }
 
     // Reset colori iniziali
-    duty_R = 0; duty_G = 0; duty_B = 0;
+    set_rgb(0, 0, 0);
+    console_init(&con, rgb_cmds, sizeof(rgb_cmds) / sizeof(rgb_cmds[0]), RgbKey);
 
     // Imposta direzione pulsanti come INPUT
     *gpio_buttons_tri = 0xFFFFFFFF;
 
-    // Configurazione manuale Interrupt Controller
-    *IER = XPAR_AXI_TIMER_0_INTERRUPT_MASK; // Abilita interrupt del timer
-    *MER = 0x3; // Abilita uscita hardware interrupt
-    microblaze_enable_interrupts(); // Abilita interrupt CPU
+    // Configurazione Interrupt Controller: abilita interrupt del timer
+    app_core_irq_enable(XPAR_AXI_TIMER_0_INTERRUPT_MASK);
 
     // Inizializza e avvia il Timer Hardware
 	Status = TmrCtrLowLevelExample(TMRCTR_BASEADDR, TIMER_COUNTER_0);
@@ -66,34 +101,108 @@ int main(void){
 		return XST_FAILURE;
     }
 
-	while(1) {
-        // Legge stato pulsanti
-        button_input = Xil_In32(XPAR_GPIO_5_BASEADDR);
-        if(button_input)
-			update_leds(button_input, 0); // Modalità 0 = Pulsante
+	return XST_SUCCESS;
+}
 
-        // Legge dati dalla seriale (UART)
-        uart_input = my_XUartLite_RecvByte(UART_BASEADDR);
-        if (uart_input != NO_DATA) {
-            update_leds(uart_input, 1); // Modalità 1 = UART
-        }
+// Un giro del loop: legge lo stato dei pulsanti
+static void RgbStep(void)
+{
+    u32 button_input = Xil_In32(XPAR_GPIO_5_BASEADDR);
+    if(button_input)
+        update_leds(button_input, 0); // Modalità 0 = Pulsante
+}
+
+// Dati dalla seriale (UART): prima la console a parole, che passa a
+// RgbKey i tasti singoli
+static void RgbByte(u8 c)
+{
+    if (c == '\r' || c == '\n')
+        pwm_cfg_cancel(&pwm); // La fine riga annulla un "w" in sospeso
+    console_feed(&con, c);
+}
+
+// Tasti singoli: "w<n>" e "W" configurano il PWM, il resto sono colori
+// e diagnostica. Un record di traccia per tasto eseguito (quelli del PWM
+// li registra pwm_cfg_command)
+static void RgbKey(u8 c)
+{
+    if (pwm_cfg_command(&pwm, c, isr_prof_measured(&prof_isr)) != PWM_CMD_NONE)
+        return;
+
+    // La diagnostica stampa e aspetta la seriale: fuori dalla misura
+    if (RgbDiag((char)c)) {
+        trace_log(TR_KEY, c, 0);
+        boot_mark(BOOT_PH_CMD);
+        return;
     }
+    if (c < '0' || c > '9')
+        return;     // Non è un colore
 
-	return XST_SUCCESS;
+    trace_log(TR_KEY, c, 0);
+    boot_mark(BOOT_PH_CMD);
+    ISR_PROF_BEGIN(t_upd);
+    update_leds(c, 1); // Modalità 1 = UART
+    ISR_PROF_END(prof_update, t_upd);
+}
+
+// Arresto: timer fermo e LED RGB spenti (Active Low)
+static void RgbStop(void)
+{
+    app_core_timer_stop(TMRCTR_BASEADDR, TIMER_COUNTER_0);
+    *gpio_rgb_data = 0x7;
+}
+
+// --- COMANDI A PAROLE ---
+// Valori fuori campo saturano a 0-255
+static u8 clamp8(s32 v)
+{
+    return (v < 0) ? 0 : (v > 255) ? 255 : (u8)v;
+}
+
+static void CmdRgb(const s32 *argv, u8 argc)
+{
+    ISR_PROF_BEGIN(t_upd);
+    set_rgb(clamp8(argv[0]), clamp8(argv[1]), clamp8(argv[2]));
+    ISR_PROF_END(prof_update, t_upd);
+}
+
+static void CmdInfo(const s32 *argv, u8 argc)
+{
+    xil_printf("RGB %d %d %d (duty %d %d %d)\r\n",
+               (int)color[0], (int)color[1], (int)color[2],
+               (int)duty_R, (int)duty_G, (int)duty_B);
+    pwm_cfg_print(&pwm.cfg);
+}
+
+static void CmdHz(const s32 *argv, u8 argc)
+{
+    pwm_cfg_console(&pwm, argv, argc, isr_prof_measured(&prof_isr));
+}
+
+// Colore in luminosità percepita (0-255 per canale): la curva gamma
+// (fixmath.h) la trasforma in duty, così 128 sembra davvero metà
+static void set_rgb(u8 r, u8 g, u8 b)
+{
+    color[0] = r; color[1] = g; color[2] = b;
+    trace_log(TR_RGB, r, ((u16)g << 8) | b);
+    duty_R = fix_gamma8(r);
+    duty_G = fix_gamma8(g);
+    duty_B = fix_gamma8(b);
 }
 
 // Funzione per aggiornare i colori dei LED
-void update_leds(u32 data, u8 mode)
+static void update_leds(u32 data, u8 mode)
 {
-    static u32 last_debounce_time = 0;
+    static u64 last_debounce_time = 0;
     static int seq_index = 2; 
 
-    u32 debounce_delay = 125000; // Ritardo per antirimbalzo
+    const u64 debounce_delay = TB_MS_TO_TICKS(500); // Ritardo per antirimbalzo (0.5 s)
+    u64 now = timebase_now();
 
     // Se premuto pulsante (Mode 0)
     if (mode == 0) {
         // Controllo debounce temporale
-        if (sys_time - last_debounce_time > debounce_delay) {
+        if (now - last_debounce_time > debounce_delay) {
             
             // Cambia colore in sequenza
             seq_index++;
@@ -102,80 +211,75 @@ void update_leds(u32 data, u8 mode)
             }
 
             if (seq_index == 0) {
-                duty_R = 255; duty_G = 0; duty_B = 0; // Rosso
+                set_rgb(255, 0, 0); // Rosso
             }
             else if (seq_index == 1) {
-                duty_R = 0; duty_G = 255; duty_B = 0; // Verde
+                set_rgb(0, 255, 0); // Verde
             }
             else {
-                duty_R = 0; duty_G = 0; duty_B = 255; // Blu
+                set_rgb(0, 0, 255); // Blu
             }
 
-            last_debounce_time = sys_time;
+            last_debounce_time = now;
         }
     }
     // Se comando da UART (Mode 1)
     else {
         switch ((char)data) {
-            case '1': duty_R = 255; duty_G = 0;   duty_B = 0;   break; // Rosso
-            case '2': duty_R = 0;   duty_G = 255; duty_B = 0;   break; // Verde
-            case '3': duty_R = 0;   duty_G = 0;   duty_B = 255; break; // Blu
-            case '4': duty_R = 255; duty_G = 255; duty_B = 0;   break; // Giallo
-            case '5': duty_R = 0;   duty_G = 255; duty_B = 255; break; // Ciano
-            case '6': duty_R = 255; duty_G = 0;   duty_B = 255; break; // Magenta
-            case '7': duty_R = 255; duty_G = 255; duty_B = 255; break; // Bianco
-            case '8': duty_R = 255; duty_G = 128; duty_B = 0;   break; // Arancio
-            case '9': duty_R = 128; duty_G = 0;   duty_B = 128; break; // Viola
-            case '0': duty_R = 0;   duty_G = 0;   duty_B = 0;   break; // Spento
+            case '1': set_rgb(255,   0,   0); break; // Rosso
+            case '2': set_rgb(  0, 255,   0); break; // Verde
+            case '3': set_rgb(  0,   0, 255); break; // Blu
+            case '4': set_rgb(255, 255,   0); break; // Giallo
+            case '5': set_rgb(  0, 255, 255); break; // Ciano
+            case '6': set_rgb(255,   0, 255); break; // Magenta
+            case '7': set_rgb(255, 255, 255); break; // Bianco
+            case '8': set_rgb(255, 128,   0); break; // Arancio
+            case '9': set_rgb(128,   0, 128); break; // Viola
+            case '0': set_rgb(  0,   0,   0); break; // Spento
             default: break;
         }
     }
 }
 
-// Funzione di lettura UART a basso livello
-u32 my_XUartLite_RecvByte(UINTPTR BaseAddress) 
-{ 
-    u32 status = XUartLite_GetStatusReg(BaseAddress);
-    // Verifica se c'è un dato valido nel buffer FIFO
-    if (status & XUL_SR_RX_FIFO_VALID_DATA) {
-        u32 data = XUartLite_ReadReg(BaseAddress, XUL_RX_FIFO_OFFSET);
-        // Ignora invio/a capo
-        if ((u8)data == 0x0D || (u8)data == 0x0A) return NO_DATA;
-        return data;
+// Tasti di diagnostica (stampe bloccanti): 1 se il tasto era uno di questi
+static int RgbDiag(char c)
+{
+    switch (c) {
+        case 'p': // Profilo dei cicli rispetto ai budget
+            isr_prof_report("myISR", &prof_isr, ISR_BUDGET_PWM_UART);
+            isr_prof_report("update_leds", &prof_update, LOOP_BUDGET_RGB_UPDATE);
+            console_report(&con);
+            return 1;
+        case 'm': // Uso massimo dello stack
+            stack_print();
+            return 1;
     }
-    return NO_DATA;
-} 
+    return 0;
+}
 
 // Configurazione Timer Hardware
-int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TmrCtrNumber)
+static int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TmrCtrNumber)
 {
-	u32 ControlStatus;
-    // Setup: Auto-Reload, Interrupt abilitati, Conteggio a scendere
-    XTmrCtr_SetControlStatusReg(TmrCtrBaseAddress, TmrCtrNumber, XTC_CSR_AUTO_RELOAD_MASK|XTC_CSR_ENABLE_INT_MASK|XTC_CSR_DOWN_COUNT_MASK);
-    XTmrCtr_SetLoadReg(TmrCtrBaseAddress, TmrCtrNumber, 400); // Imposta periodo timer (frequenza PWM)
-	XTmrCtr_LoadTimerCounterReg(TmrCtrBaseAddress, TmrCtrNumber);
-    
-    // Avvia il timer
-    ControlStatus = XTmrCtr_GetControlStatusReg(TmrCtrBaseAddress, TmrCtrNumber);
-    XTmrCtr_SetControlStatusReg(TmrCtrBaseAddress, TmrCtrNumber, ControlStatus & (~XTC_CSR_LOAD_MASK));
-	XTmrCtr_Enable(TmrCtrBaseAddress, TmrCtrNumber);
+    // Setup: Auto-Reload, Interrupt abilitati, Conteggio a scendere.
+    // Periodo timer (frequenza PWM) e risoluzione da pwm_cfg, validati
+    // contro i cicli misurati della ISR; poi avvia il timer.
+	pwm_rt_init(&pwm, TmrCtrBaseAddress, TmrCtrNumber, isr_prof_measured(&prof_isr));
 	return XST_SUCCESS;
 }
 
 // Interrupt Service Routine (Eseguita a ogni tick del timer)
-void myISR(void)
+static void RgbISR(u32 p)
 {
-    unsigned p = *IISR;
+    ISR_PROF_BEGIN(t_isr);
     // Controlla se l'interrupt arriva dal Timer 0
     if (p & XPAR_AXI_TIMER_0_INTERRUPT_MASK) {
 
-        pwm_counter++; // Incrementa fase PWM
-        sys_time++;    // Incrementa tempo sistema
+        u8 phase = pwm_rt_tick(&pwm); // Incrementa fase PWM (e cambia configurazione a fine periodo)
 
         // Calcola se accendere o spegnere ogni colore (Logica PWM)
-        u32 r_bit = (pwm_counter < duty_R) ? 0 : 1;
-        u32 g_bit = (pwm_counter < duty_G) ? 0 : 1;
-        u32 b_bit = (pwm_counter < duty_B) ? 0 : 1;
+        u32 r_bit = (phase < duty_R) ? 0 : 1;
+        u32 g_bit = (phase < duty_G) ? 0 : 1;
+        u32 b_bit = (phase < duty_B) ? 0 : 1;
 
         // Invia i bit ai LED RGB
         u32 rgb_output = (r_bit << 2) | (g_bit << 1) | (b_bit << 0);
@@ -184,6 +288,9 @@ void myISR(void)
         // Pulisce il flag di interrupt per permettere il prossimo
         int ControlStatus = XTmrCtr_GetControlStatusReg(TMRCTR_BASEADDR, 0);
         XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, 0, ControlStatus | (XTC_CSR_INT_OCCURED_MASK));
-        *IIAR |= XPAR_AXI_TIMER_0_INTERRUPT_MASK;
+        *IIAR = XPAR_AXI_TIMER_0_INTERRUPT_MASK; // Registro di sola scrittura: niente |=
     }
+
+    ISR_PROF_END(prof_isr, t_isr);
+    boot_mark(BOOT_PH_PWM); // Fuori dalla misura che valida il PWM
 }
@@ -2,6 +2,11 @@
 #include "xtmrctr_l.h"
 #include "xil_printf.h"
 #include "xparameters.h"
+#include "isr_prof.h"
+#include "isr_budget.h"
+#include "app_core.h"
+#include "boot.h"
+#include "pwm_cfg.h"
 
 // Configurazione indirizzo base del Timer
 #ifndef SDT
@@ -14,28 +19,36 @@
 
 // --- Memory Mapped I/O Pointers ---
 // Canale 1: LED Standard (offset 0x0)
-volatile int * gpio_leds_data = (volatile int *)0x40000000;
+static volatile int * gpio_leds_data = (volatile int *)0x40000000;
 // Canale 2: RGB LEDs (offset 0x8) - Secondo il diagramma AXI GPIO
-volatile int * gpio_rgb_data  = (volatile int *)0x40000008;
-
-// Interrupt Controller Registers
-volatile int * IER = (volatile int*)	0x41200008;
-volatile int * MER = (volatile int*)	0x4120001C;
-volatile int * IISR = (volatile int*)	0x41200000;
-volatile int * IIAR = (volatile int*)	0x4120000C;
+static volatile int * gpio_rgb_data  = (volatile int *)0x40000008;
 
 // --- PWM Global Variables ---
-// Risoluzione a 8 bit (0-255)
-volatile u8 pwm_counter = 0;
-volatile u8 duty_R = 0;
-volatile u8 duty_G = 0;
-volatile u8 duty_B = 0;
+// Duty a 8 bit (0-255); frequenza e risoluzione effettiva da pwm_cfg ("w<n>", "W")
+static pwm_rt_t pwm;
+static volatile u8 duty_R = 0;
+static volatile u8 duty_G = 0;
+static volatile u8 duty_B = 0;
+
+// Misura dei cicli della ISR (attiva solo con ISR_PROFILE)
+static isr_prof_t prof_isr = ISR_PROF_INIT;
 
 // Prototipi
-void myISR(void) __attribute__((interrupt_handler));
-int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TimerCounter);
+static int PwmInit(void);
+static void PwmStep(void);
+static void PwmISR(u32 p);
+static void PwmByte(u8 c);
+static void PwmStop(void);
+static int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TimerCounter);
+
+// Modulo del nucleo (app_core.h)
+const app_module_t app_pwm = { "pwm", PwmInit, PwmStep, PwmISR, PwmByte, PwmStop };
+
+#ifndef APP_SINGLE_IMAGE
+APP_STANDALONE_MAIN(app_pwm)
+#endif
 
-int main(void)
+static int PwmInit(void)
 {
 	int Status;
 
@@ -46,9 +59,7 @@ int main(void)
     duty_B = 0;
 
 	// Setup Interrupt Controller
-    *IER = XPAR_AXI_TIMER_0_INTERRUPT_MASK;
-    *MER = 0x3;
-    microblaze_enable_interrupts();
+    app_core_irq_enable(XPAR_AXI_TIMER_0_INTERRUPT_MASK);
 
 	Status = TmrCtrLowLevelExample(TMRCTR_BASEADDR, TIMER_COUNTER_0);
 	if (Status != XST_SUCCESS) {
@@ -56,54 +67,54 @@ int main(void)
 		return XST_FAILURE;
 	}
 
-    // Loop infinito: qui si possono cambiare i colori dinamicamente
-	while(1) {
-        // Esempio: effetto "fade" o cambio colore si potrebbe fare qui
-        // modificando duty_R, duty_G, duty_B
-    }
-
 	return XST_SUCCESS;
 }
 
-int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TmrCtrNumber)
+// Un giro del loop: qui si possono cambiare i colori dinamicamente
+static void PwmStep(void)
 {
-	u32 ControlStatus;
-
-    // 1. Imposta Control Status Register (Auto Reload + Interrupt + Down Count)
-    XTmrCtr_SetControlStatusReg(TmrCtrBaseAddress, TmrCtrNumber, XTC_CSR_AUTO_RELOAD_MASK|XTC_CSR_ENABLE_INT_MASK|XTC_CSR_DOWN_COUNT_MASK);
-
-    // 2. Calcolo del Timer Load Value per PWM
-    // Formula: f_int = f_sys / LoadValue.
-    // Target: Vogliamo f_pwm > 1kHz
-    // Se f_sys = 100MHz e LoadValue = 400:
-    // f_int = 250 kHz.
-    // f_pwm = f_int / 256 (8 bit) ~= 976 Hz (circa 1kHz).
-    // Valore impostato a 400 clock ticks.
-    XTmrCtr_SetLoadReg(TmrCtrBaseAddress, TmrCtrNumber, 400);
-
-    // 3. Carica il valore
-	XTmrCtr_LoadTimerCounterReg(TmrCtrBaseAddress, TmrCtrNumber);
+    // Esempio: effetto "fade" o cambio colore si potrebbe fare qui
+    // modificando duty_R, duty_G, duty_B
+    ISR_PROF_CHECK("PWM myISR", prof_isr, ISR_BUDGET_PWM);
+}
 
-    // 4. Pulisce bit di Load
-    ControlStatus = XTmrCtr_GetControlStatusReg(TmrCtrBaseAddress, TmrCtrNumber);
-	XTmrCtr_SetControlStatusReg(TmrCtrBaseAddress, TmrCtrNumber, ControlStatus & (~XTC_CSR_LOAD_MASK));
+// Seriale: solo la configurazione del PWM (w<n> preset, W tabella)
+static void PwmByte(u8 c)
+{
+    pwm_cfg_command(&pwm, c, isr_prof_measured(&prof_isr));
+}
 
-    // 5. Abilita il timer
-	XTmrCtr_Enable(TmrCtrBaseAddress, TmrCtrNumber);
+// Arresto: timer fermo e LED RGB spenti (Active Low)
+static void PwmStop(void)
+{
+    app_core_timer_stop(TMRCTR_BASEADDR, TIMER_COUNTER_0);
+    *gpio_rgb_data = 0x7;
+}
 
+static int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TmrCtrNumber)
+{
+    // Calcolo del Timer Load Value per PWM (dettagli in pwm_cfg.h)
+    // Formula: f_int = f_sys / periodo, f_pwm = f_int / 2^bit.
+    // Di fabbrica: f_sys = 100MHz, periodo 400 -> f_int = 250 kHz,
+    // f_pwm = f_int / 256 (8 bit) ~= 976 Hz (circa 1kHz).
+    // La configurazione deve lasciare alla CPU il tempo per il resto:
+    // viene validata contro i cicli misurati della ISR.
+    // Auto Reload + Interrupt + Down Count, poi avvio del timer.
+	pwm_rt_init(&pwm, TmrCtrBaseAddress, TmrCtrNumber, isr_prof_measured(&prof_isr));
 	return XST_SUCCESS;
 }
 
 // --- ISR: Gestione PWM ---
-void myISR(void)
+// p = snapshot di IISR letto dalla myISR del nucleo
+static void PwmISR(u32 p)
 {
-    unsigned p = *IISR;
+    ISR_PROF_BEGIN(t_isr);
     if (p & XPAR_AXI_TIMER_0_INTERRUPT_MASK) {
 
-        // 1. Incremento contatore globale
-        pwm_counter++;
-        // Il contatore è u8, quindi farà overflow da 255 a 0 automaticamente,
-        // creando il ciclo periodico richiesto
+        // 1. Avanzamento della fase (u8: fa overflow a 0 a fine periodo,
+        // creando il ciclo periodico richiesto). A fine periodo applica
+        // l'eventuale nuova frequenza/risoluzione.
+        u8 phase = pwm_rt_tick(&pwm);
 
         // 2. Calcolo stato LED (Active Low: 0=ON, 1=OFF)
         // Se il contatore è minore del duty cycle, il LED deve essere ACCESO (LOW).
@@ -113,9 +124,9 @@ void myISR(void)
         u32 r_bit, g_bit, b_bit;
 
         // Logica: Output 0 (LOW) se counter < duty, altrimenti 1 (HIGH)
-        r_bit = (pwm_counter < duty_R) ? 0 : 1;
-        g_bit = (pwm_counter < duty_G) ? 0 : 1;
-        b_bit = (pwm_counter < duty_B) ? 0 : 1;
+        r_bit = (phase < duty_R) ? 0 : 1;
+        g_bit = (phase < duty_G) ? 0 : 1;
+        b_bit = (phase < duty_B) ? 0 : 1;
 
         // Assembla i bit. Assumiamo la mappatura standard Cmod A7:
         // Bit 0: Blu, Bit 1: Verde, Bit 2: Rosso 
@@ -129,8 +140,11 @@ void myISR(void)
         XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, 0, ControlStatus | (XTC_CSR_INT_OCCURED_MASK));
 
         // 4. Pulisce Interrupt Controller
-        *IIAR |= XPAR_AXI_TIMER_0_INTERRUPT_MASK;
+        *IIAR = XPAR_AXI_TIMER_0_INTERRUPT_MASK; // Registro di sola scrittura: niente |=
     }
+
+    ISR_PROF_END(prof_isr, t_isr);
+    boot_mark(BOOT_PH_PWM); // Fuori dalla misura che valida il PWM
 }
 
 
@@ -2,79 +2,169 @@
 #include "xstatus.h"
 #include "xtmrctr_l.h"
 #include "xil_printf.h"
-#include "xuartlite_l.h"
 #include "xil_io.h"
+#include "fsm_engine.h"
+#include "timebase.h"
+#include "dpc.h"
+#include "gpio_shadow.h"
+#include "motor_ramp.h"
+#include "stack_mon.h"
+#include "isr_prof.h"
+#include "isr_budget.h"
+#include "app_core.h"
+#include "boot.h"
+#include "pwm_cfg.h"
+#include "fixmath.h"
+#include "console.h"
+#include "trace.h"
+#include "mb_interface.h"
 
 // --- INDIRIZZI HARDWARE ---
 // Qui diciamo al programma dove trovare le periferiche nella memoria della scheda
 #ifndef SDT
     #define TMRCTR_BASEADDR     XPAR_TMRCTR_0_BASEADDR
-    #define UART_BASEADDR       XPAR_UARTLITE_0_BASEADDR
     #define GPIO_MOTORS_BASE    XPAR_GPIO_MOTORS_BASEADDR
     #define GPIO_LEDS_BASE      0x40000000
 #else
     #define TMRCTR_BASEADDR     XPAR_XTMRCTR_0_BASEADDR
-    #define UART_BASEADDR       XPAR_XUARTLITE_0_BASEADDR
 #endif
 
-#define NO_DATA             0xFFFFFFFF
-
 // --- CONFIGURAZIONE DEI DUE TIMER ---
 #define TIMER_PWM           0  // Timer 0: Controlla la velocità dei motori (veloce)
 #define TIMER_BLINK         1  // Timer 1: Controlla il lampeggio delle frecce (lento)
 
-#define PWM_PERIOD          400       // Durata breve per dare potenza fluida ai motori
+// Il PWM dei motori è configurabile a runtime (pwm_cfg.h, comandi "w<n>" e "W"):
+// di fabbrica 400 cicli per tick e 8 bit, cioè ~976 Hz
 #define BLINK_PERIOD        50000000  // Durata lunga (mezzo secondo) per le frecce
 
-// --- PUNTATORI AI PIN (GPIO) ---
-// Variabili speciali che scrivono direttamente sui cavi fisici di LED e Motori
-volatile int * leds_data = (volatile int *)(GPIO_LEDS_BASE + 0x00);
-volatile int * leds_tri  = (volatile int *)(GPIO_LEDS_BASE + 0x04);
+// --- RAMPE DEI MOTORI ---
+// Niente salti di velocità: ogni ruota accelera da 0 a 255 in RAMP_FULL_MS
+// (avanzando a ogni tick PWM) e passa da zero prima di invertire.
+// RAMP_JERK > 0 attiva la curva a S (più morbida all'inizio e alla fine).
+// Il rate dipende dal tick PWM: RAMP_RATE vale per quello di fabbrica,
+// UpdateRampRate lo ricalcola a ogni cambio di configurazione.
+#define PWM_TICK_HZ         (PWM_CLK_HZ / 400)
+#define RAMP_FULL_MS        400
+#define RAMP_RATE           RAMP_RATE_FULL_MS(RAMP_FULL_MS, PWM_TICK_HZ)
+#define RAMP_JERK           0
+
+// --- MISCELAZIONE DELLE VELOCITÀ ---
+// Nelle curve la ruota interna gira a una frazione della velocità di
+// crociera (fattori Q8.8 di fixmath.h, niente moltiplicazioni di libgcc):
+// cambiando SPD_MAX le curve restano in proporzione.
+#define SPD_MAX             150
+#define TURN_WIDE           FIX_Q8(2.0 / 3.0)  // Curva larga: ruota interna a 2/3 (100)
+#define TURN_TIGHT          FIX_Q8(1.0 / 3.0)  // Curva stretta: ruota interna a 1/3 (50)
 
-volatile int * motors_speed_dir_data = (volatile int *)(GPIO_MOTORS_BASE + 0x00);
-volatile int * motors_speed_dir_tri  = (volatile int *)(GPIO_MOTORS_BASE + 0x04);
-volatile int * motors_enable_data    = (volatile int *)(GPIO_MOTORS_BASE + 0x08);
-volatile int * motors_enable_tri     = (volatile int *)(GPIO_MOTORS_BASE + 0x0C);
+// --- PUNTATORI AI PIN (GPIO) ---
+// Variabili speciali che scrivono direttamente sui cavi fisici di LED e Motori.
+// I LED passano dalla loro copia ombra: una sola scrittura, mai una lettura.
+static gpio_shadow_t leds = GPIO_SHADOW_INIT(GPIO_LEDS_BASE + 0x00);
+static volatile int * leds_tri  = (volatile int *)(GPIO_LEDS_BASE + 0x04);
 
-// Registri per gestire le interruzioni (il "campanello" del processore)
-volatile int * IER  = (volatile int *)0x41200008;
-volatile int * MER  = (volatile int *)0x4120001C;
-volatile int * IISR = (volatile int *)0x41200000;
-volatile int * IIAR = (volatile int *)0x4120000C;
+static volatile int * motors_speed_dir_data = (volatile int *)(GPIO_MOTORS_BASE + 0x00);
+static volatile int * motors_speed_dir_tri  = (volatile int *)(GPIO_MOTORS_BASE + 0x04);
+static volatile int * motors_enable_data    = (volatile int *)(GPIO_MOTORS_BASE + 0x08);
+static volatile int * motors_enable_tri     = (volatile int *)(GPIO_MOTORS_BASE + 0x0C);
 
 // --- MEMORIA DI SISTEMA ---
-volatile u8 pwm_counter = 0; // Conta ciclicamente per generare l'onda PWM
-volatile u8 speed_R = 0;     // Velocità destra
-volatile u8 speed_L = 0;     // Velocità sinistra
-volatile u8 dir_R = 0;       // Direzione destra
-volatile u8 dir_L = 0;       // Direzione sinistra
+static pwm_rt_t pwm;                // Fase e configurazione dell'onda PWM
+static motor_ramp_t ramp_R;         // Velocità e direzione destra (con rampa)
+static motor_ramp_t ramp_L;         // Velocità e direzione sinistra (con rampa)
 
 // Variabili per le frecce
-volatile int blink_state = 0; // Stato della luce (accesa/spenta)
-volatile int turn_mode = 0;   // Dove stiamo girando (0=dritto, 1=SX, 2=DX)
+static volatile int blink_state = 0; // Stato della luce (accesa/spenta)
+
+// Misura dei cicli (attiva solo con ISR_PROFILE), stampate con il comando 'p'
+static isr_prof_t prof_isr = ISR_PROF_INIT;
+static isr_prof_t prof_tick = ISR_PROF_INIT;   // Solo il ramo del tick motori
+static isr_prof_t prof_cmd = ISR_PROF_INIT;
+static isr_prof_t prof_ramp = ISR_PROF_INIT;
+
+// Macchina a stati delle frecce: dove stiamo girando (dritto, SX, DX)
+typedef enum { TURN_OFF, TURN_LEFT, TURN_RIGHT, TURN_N_STATES } turn_state_t;
+typedef enum { EV_CMD_STRAIGHT, EV_CMD_LEFT, EV_CMD_RIGHT, EV_BLINK, TURN_N_EVENTS } turn_event_t;
 
 // Elenco delle funzioni usate
-void myISR(void) __attribute__((interrupt_handler));
-int SetupTimer(void);
-u32 UART_RecvByte(UINTPTR BaseAddress);
-void ProcessCommand(char cmd);
-void UpdateTurnSignals(void);
-
-// --- PROGRAMMA PRINCIPALE ---
-int main(void) {
-    int Status;
-    u32 uart_input;
+static int RoverInit(void);
+static void RoverISR(u32 p);
+static void RoverByte(u8 c);
+static void RoverStop(void);
+static int SetupTimer(void);
+static void UpdateRampRate(void);
+static int ProcessCommand(char cmd);
+static void SetCurve(u8 speed, q8_8_t k_R, q8_8_t k_L);
+static void SetMotors(u8 spd_R, u8 dir_R, u8 spd_L, u8 dir_L);
+static void SetTurnSignal(turn_event_t ev);
+static void BlinkWork(u32 arg);
+static void RoverBanner(u32 arg);
+static void RoverKey(u8 c);
+static int RoverDiag(char c);
+static void CmdVel(const s32 *argv, u8 argc);
+static void CmdInfo(const s32 *argv, u8 argc);
+static void CmdHz(const s32 *argv, u8 argc);
+
+// Comandi a parole (console.h); i tasti singoli restano quelli di RoverKey.
+// Nessuna parola inizia con un tasto di RoverKey: la prima lettera arriva
+// comunque al gestore, ma lì non fa nulla.
+static const console_cmd_t rover_cmds[] = {
+    { "vel",  2, 2, CmdVel,  "vel R L (-255..255, negativo = indietro)" },
+    { "info", 0, 0, CmdInfo, "info" },
+    { "hz",   0, 2, CmdHz,   "hz [Hz [bit]]" },
+};
+static console_t con;
+
+// Il rover come modulo del nucleo (app_core.h): niente passo nel loop,
+// il lavoro lento arriva dalla coda DPC che il nucleo esegue
+const app_module_t app_rover = { "rover", RoverInit, NULL, RoverISR, RoverByte, RoverStop };
+
+// --- AZIONI DELLE FRECCE ---
+static void LedsOff(void *ctx)   { gpio_sh_write(&leds, 0x0); }
+static void ShowLeft(void *ctx)  { gpio_sh_write(&leds, (blink_state) ? 0x1 : 0x0); } // Freccia SX
+static void ShowRight(void *ctx) { gpio_sh_write(&leds, (blink_state) ? 0x2 : 0x0); } // Freccia DX
+
+static const fsm_transition_t turn_table[TURN_N_STATES][TURN_N_EVENTS] = {
+    [TURN_OFF][EV_CMD_LEFT]         = FSM_GOTO(TURN_LEFT,  NULL),
+    [TURN_OFF][EV_CMD_RIGHT]        = FSM_GOTO(TURN_RIGHT, NULL),
+
+    [TURN_LEFT][EV_CMD_STRAIGHT]    = FSM_GOTO(TURN_OFF,   NULL),
+    [TURN_LEFT][EV_CMD_RIGHT]       = FSM_GOTO(TURN_RIGHT, NULL),
+    [TURN_LEFT][EV_BLINK]           = FSM_DO(ShowLeft),
+
+    [TURN_RIGHT][EV_CMD_STRAIGHT]   = FSM_GOTO(TURN_OFF,   NULL),
+    [TURN_RIGHT][EV_CMD_LEFT]       = FSM_GOTO(TURN_LEFT,  NULL),
+    [TURN_RIGHT][EV_BLINK]          = FSM_DO(ShowRight),
+};
+
+static const fsm_action_t turn_entry[TURN_N_STATES] = {
+    [TURN_OFF]   = LedsOff,
+    [TURN_LEFT]  = ShowLeft,
+    [TURN_RIGHT] = ShowRight,
+};
+
+static const fsm_def_t turn_fsm_def = FSM_DEF(turn_table, turn_entry, NULL);
+static fsm_t turn_fsm;
+
+#ifndef APP_SINGLE_IMAGE
+APP_STANDALONE_MAIN(app_rover)
+#endif
 
-    xil_printf("Sistema Avviato. In attesa di comandi...\r\n");
+// --- AVVIO DEL MODULO ---
+// Prima uscite e timer, per ultima la stampa (bloccante sulla seriale)
+static int RoverInit(void) {
+    int Status;
 
     // Configura i pin come USCITA
     *leds_tri = 0x00;
     *motors_speed_dir_tri = 0x00;
     *motors_enable_tri = 0x00;
 
-    // Spegne tutto all'inizio
-    *leds_data = 0x00;
+    // Spegne tutto all'inizio (frecce spente = ingresso in TURN_OFF)
+    fsm_init(&turn_fsm, &turn_fsm_def, TURN_OFF, NULL);
     *motors_speed_dir_data = 0x00;
+    motor_ramp_init(&ramp_R, RAMP_RATE, RAMP_JERK);
+    motor_ramp_init(&ramp_L, RAMP_RATE, RAMP_JERK);
+    console_init(&con, rover_cmds, sizeof(rover_cmds) / sizeof(rover_cmds[0]), RoverKey);
 
     // Accende il chip dei motori
     *motors_enable_data = 0x01;
@@ -82,146 +172,280 @@ int main(void) {
     // Prepara i timer (motori e frecce)
     Status = SetupTimer();
     if (Status != XST_SUCCESS) return XST_FAILURE;
-
-    // Ciclo infinito: controlla sempre se arrivano comandi dalla tastiera
-    while (1) {
-        uart_input = UART_RecvByte(UART_BASEADDR);
-        if (uart_input != NO_DATA) {
-            ProcessCommand((char)uart_input);
-        }
+    UpdateRampRate();
+
+    // Il messaggio di avvio è lento (oltre la FIFO della seriale): lo
+    // stampa il main dopo il cambio, fuori dal tempo misurato.
+    // dpc_post vuole gli interrupt disabilitati (la ISR è l'altro produttore)
+    {
+        u32 msr = mfmsr();
+        microblaze_disable_interrupts();
+        dpc_post(RoverBanner, 0);
+        mtmsr(msr);
     }
     return XST_SUCCESS;
 }
 
-// --- GESTIONE DEI COMANDI ---
-// Legge il tasto premuto e imposta velocità e direzione
-void ProcessCommand(char cmd) {
-    const u8 SPD_MAX = 150;
-    const u8 SPD_MED = 100;
-    const u8 SPD_LOW = 50;
+static void RoverBanner(u32 arg) {
+    xil_printf("Sistema Avviato. In attesa di comandi...\r\n");
+}
+
+// --- ARRESTO DEL MODULO ---
+// Ferma i timer e lascia il rover in stato sicuro: motori fermi e
+// disabilitati, frecce spente
+static void RoverStop(void) {
+    app_core_timer_stop(TMRCTR_BASEADDR, TIMER_PWM);
+    app_core_timer_stop(TMRCTR_BASEADDR, TIMER_BLINK);
 
+    *motors_speed_dir_data = 0x00;
+    *motors_enable_data = 0x00;
+    gpio_sh_write(&leds, 0x0);
+}
+
+// Ogni byte ricevuto dalla seriale: prima la console a parole, che
+// passa a RoverKey i tasti singoli
+static void RoverByte(u8 c) {
+    if (c == '\r' || c == '\n')
+        pwm_cfg_cancel(&pwm); // La fine riga annulla un "w" in sospeso
+    console_feed(&con, c);
+}
+
+// Un record di traccia per ogni tasto eseguito (quelli del PWM li
+// registra pwm_cfg_command), fuori dalla misura dei cicli
+static void RoverKey(u8 c) {
+    int done;
+
+    // Prima la configurazione del PWM ("w<n>", "W")
+    int pwm_cmd = pwm_cfg_command(&pwm, c, isr_prof_measured(&prof_tick));
+    if (pwm_cmd == PWM_CMD_CHANGED) UpdateRampRate();
+    if (pwm_cmd != PWM_CMD_NONE) return;
+
+    // La diagnostica stampa e aspetta la seriale: fuori dalla misura
+    if (RoverDiag((char)c)) {
+        trace_log(TR_KEY, c, 0);
+        boot_mark(BOOT_PH_CMD);
+        return;
+    }
+
+    ISR_PROF_BEGIN(t_cmd);
+    done = ProcessCommand((char)c);
+    ISR_PROF_END(prof_cmd, t_cmd);
+    if (done) {
+        trace_log(TR_KEY, c, 0);
+        boot_mark(BOOT_PH_CMD);
+    }
+}
+
+// --- GESTIONE DEI COMANDI ---
+// Legge il tasto premuto e imposta velocità e direzione: 1 se il tasto
+// era un comando
+static int ProcessCommand(char cmd) {
     switch (cmd) {
         // Movimenti dritti
         case 'f': // Avanti
-            dir_R = 1; dir_L = 1; speed_R = SPD_MAX; speed_L = SPD_MAX;
-            turn_mode = 0; *leds_data = 0x0;
+            SetMotors(SPD_MAX, 1, SPD_MAX, 1);
+            SetTurnSignal(EV_CMD_STRAIGHT);
             break;
 
         case 'b': // Indietro
-            dir_R = 0; dir_L = 0; speed_R = SPD_MAX; speed_L = SPD_MAX;
-            turn_mode = 0; *leds_data = 0x0;
+            SetMotors(SPD_MAX, 0, SPD_MAX, 0);
+            SetTurnSignal(EV_CMD_STRAIGHT);
             break;
 
         case 's': // Stop
-            speed_R = 0; speed_L = 0; dir_R = 0; dir_L = 0;
-            turn_mode = 0; *leds_data = 0x0;
+            SetMotors(0, 0, 0, 0);
+            SetTurnSignal(EV_CMD_STRAIGHT);
             break;
 
         // Rotazioni su se stesso (Pivot)
         case 'l': // Ruota a Sinistra
-            dir_R = 1; dir_L = 0; speed_R = SPD_MAX; speed_L = SPD_MAX;
-            turn_mode = 1; // Attiva freccia SX
+            SetMotors(SPD_MAX, 1, SPD_MAX, 0);
+            SetTurnSignal(EV_CMD_LEFT); // Attiva freccia SX
             break;
 
         case 'r': // Ruota a Destra
-            dir_R = 0; dir_L = 1; speed_R = SPD_MAX; speed_L = SPD_MAX;
-            turn_mode = 2; // Attiva freccia DX
+            SetMotors(SPD_MAX, 0, SPD_MAX, 1);
+            SetTurnSignal(EV_CMD_RIGHT); // Attiva freccia DX
             break;
 
         // Curve Larghe (un motore veloce, uno medio)
         case 'q': 
-            dir_R = 1; dir_L = 1; speed_R = SPD_MAX; speed_L = SPD_MED;
-            turn_mode = 1; 
+            SetCurve(SPD_MAX, FIX_Q8_ONE, TURN_WIDE);
+            SetTurnSignal(EV_CMD_LEFT);
             break;
 
         case 'e': 
-            dir_R = 1; dir_L = 1; speed_R = SPD_MED; speed_L = SPD_MAX;
-            turn_mode = 2; 
+            SetCurve(SPD_MAX, TURN_WIDE, FIX_Q8_ONE);
+            SetTurnSignal(EV_CMD_RIGHT);
             break;
 
         // Curve Strette (un motore veloce, uno lento)
         case 'z': 
-            dir_R = 1; dir_L = 1; speed_R = SPD_MAX; speed_L = SPD_LOW;
-            turn_mode = 1; 
+            SetCurve(SPD_MAX, FIX_Q8_ONE, TURN_TIGHT);
+            SetTurnSignal(EV_CMD_LEFT);
             break;
 
         case 'c': 
-            dir_R = 1; dir_L = 1; speed_R = SPD_LOW; speed_L = SPD_MAX;
-            turn_mode = 2; 
+            SetCurve(SPD_MAX, TURN_TIGHT, FIX_Q8_ONE);
+            SetTurnSignal(EV_CMD_RIGHT);
             break;
+
+        default:
+            return 0;
+    }
+    return 1;
+}
+
+// --- DIAGNOSTICA ---
+// Tasti che stampano (bloccanti sulla seriale): 1 se il tasto era uno di questi
+static int RoverDiag(char c) {
+    switch (c) {
+        // Statistiche del lavoro differito
+        case 'd':
+            dpc_print_stats();
+            return 1;
+
+        // Cicli della ISR e dei comandi rispetto ai budget
+        case 'p':
+            isr_prof_report("myISR", &prof_isr, ISR_BUDGET_ROVER);
+            isr_prof_report("tick motori", &prof_tick, ISR_BUDGET_ROVER_TICK);
+            isr_prof_report("ProcessCommand", &prof_cmd, LOOP_BUDGET_ROVER_CMD);
+            isr_prof_report("rampe", &prof_ramp, ISR_BUDGET_RAMP);
+            console_report(&con);
+            return 1;
+
+        // Uso massimo dello stack
+        case 'm':
+            stack_print();
+            return 1;
     }
+    return 0;
 }
 
 // --- GESTORE DELLE INTERRUZIONI (IL CUORE DEL SISTEMA) ---
-// Questa funzione viene chiamata automaticamente dall'hardware
-void myISR(void) {
-    unsigned p = *IISR; // Controlla chi ha suonato il campanello
+// La myISR del nucleo la chiama con lo stato dell'INTC (chi ha suonato il campanello)
+static void RoverISR(u32 p) {
+    ISR_PROF_BEGIN(t_isr);
 
     if (p & XPAR_AXI_TIMER_0_INTERRUPT_MASK) {
 
         // --- CASO 1: È IL TIMER DEI MOTORI? (Veloce) ---
         u32 csr_pwm = XTmrCtr_GetControlStatusReg(TMRCTR_BASEADDR, TIMER_PWM);
         if (csr_pwm & XTC_CSR_INT_OCCURED_MASK) {
+            ISR_PROF_BEGIN(t_tick);
 
-            pwm_counter++; // Incrementa il contatore
+            // Incrementa il contatore (e a fine periodo applica una nuova configurazione)
+            u8 phase = pwm_rt_tick(&pwm);
+
+            // Le rampe avanzano di un tick verso il setpoint
+            {
+                ISR_PROF_BEGIN(t_ramp);
+                motor_ramp_tick(&ramp_R);
+                motor_ramp_tick(&ramp_L);
+                ISR_PROF_END(prof_ramp, t_ramp);
+            }
 
             // Decide se dare corrente al motore in questo istante
-            u32 pwm_bit_R = (pwm_counter < speed_R) ? 1 : 0;
-            u32 pwm_bit_L = (pwm_counter < speed_L) ? 1 : 0;
+            u32 pwm_bit_R = (phase < ramp_R.speed) ? 1 : 0;
+            u32 pwm_bit_L = (phase < ramp_L.speed) ? 1 : 0;
 
             // Invia il segnale ai motori
-            u32 motor_output = (pwm_bit_R << 0) | (dir_R << 1) |
-                               (pwm_bit_L << 2) | (dir_L << 3);
+            u32 motor_output = (pwm_bit_R << 0) | ((u32)ramp_R.dir << 1) |
+                               (pwm_bit_L << 2) | ((u32)ramp_L.dir << 3);
             *motors_speed_dir_data = motor_output;
 
             // Resetta l'avviso di questo timer
             XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_PWM, csr_pwm | XTC_CSR_INT_OCCURED_MASK);
+            ISR_PROF_END(prof_tick, t_tick);
+            boot_mark(BOOT_PH_PWM); // Fuori dalla misura che valida il PWM
         }
 
         // --- CASO 2: È IL TIMER DELLE FRECCE? (Lento) ---
         u32 csr_blink = XTmrCtr_GetControlStatusReg(TMRCTR_BASEADDR, TIMER_BLINK);
         if (csr_blink & XTC_CSR_INT_OCCURED_MASK) {
 
-            // Inverte lo stato (se acceso spegne, se spento accende)
-            blink_state = !blink_state;
-            UpdateTurnSignals(); // Aggiorna i LED
+            // Il lampeggio non è urgente: lo esegue il main dopo la ISR
+            dpc_post(BlinkWork, 0);
 
             // Resetta l'avviso di questo timer
             XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_BLINK, csr_blink | XTC_CSR_INT_OCCURED_MASK);
         }
 
         // Conferma al processore di aver gestito l'evento
-        *IIAR |= XPAR_AXI_TIMER_0_INTERRUPT_MASK;
+        *IIAR = XPAR_AXI_TIMER_0_INTERRUPT_MASK;
     }
+
+    ISR_PROF_END(prof_isr, t_isr);
 }
 
-// Funzione ausiliaria per accendere il LED giusto
-void UpdateTurnSignals(void) {
-    if (turn_mode == 1) {
-        *leds_data = (blink_state) ? 0x1 : 0x0; // Freccia SX
-    }
-    else if (turn_mode == 2) {
-        *leds_data = (blink_state) ? 0x2 : 0x0; // Freccia DX
-    }
-    else {
-        *leds_data = 0x0; // Tutto spento
-    }
+// --- COMANDI A PAROLE ---
+// Velocità esatte per ruota: il segno è la direzione, il modulo satura a 255.
+// Le frecce seguono la ruota più lenta.
+static u8 SpeedAbs(s32 v) {
+    if (v < 0) v = -v;
+    return (v > 255) ? 255 : (u8)v;
 }
 
-// --- SETUP INIZIALE DEI TIMER ---
-int SetupTimer(void) {
-    // Abilita il controller delle interruzioni
-    *IER = XPAR_AXI_TIMER_0_INTERRUPT_MASK;
-    *MER = 0x3;
-
-    // Configura TIMER 0 (Motori)
-    XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_PWM, 0);
-    XTmrCtr_SetLoadReg(TMRCTR_BASEADDR, TIMER_PWM, PWM_PERIOD); // Imposta velocità alta
-    XTmrCtr_LoadTimerCounterReg(TMRCTR_BASEADDR, TIMER_PWM);
-    // Imposta modalità automatica e conto alla rovescia
-    XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_PWM,
-        XTC_CSR_AUTO_RELOAD_MASK | XTC_CSR_ENABLE_INT_MASK | XTC_CSR_DOWN_COUNT_MASK);
+static void CmdVel(const s32 *argv, u8 argc) {
+    s32 r = argv[0], l = argv[1];
 
+    ISR_PROF_BEGIN(t_cmd);
+    SetMotors(SpeedAbs(r), r >= 0, SpeedAbs(l), l >= 0);
+    SetTurnSignal((r > l) ? EV_CMD_LEFT : (l > r) ? EV_CMD_RIGHT : EV_CMD_STRAIGHT);
+    ISR_PROF_END(prof_cmd, t_cmd);
+}
+
+// Obiettivi e velocità applicate (segno = direzione), frecce e PWM
+static void CmdInfo(const s32 *argv, u8 argc) {
+    u16 sp_R = ramp_R.setpoint, sp_L = ramp_L.setpoint;
+    static const char *const turn_names[TURN_N_STATES] = { "dritto", "sinistra", "destra" };
+
+    xil_printf("Obiettivo R %d L %d, attuale R %d L %d, frecce %s\r\n",
+               (sp_R & 0x100) ? (int)(u8)sp_R : -(int)(u8)sp_R,
+               (sp_L & 0x100) ? (int)(u8)sp_L : -(int)(u8)sp_L,
+               ramp_R.dir ? (int)ramp_R.speed : -(int)ramp_R.speed,
+               ramp_L.dir ? (int)ramp_L.speed : -(int)ramp_L.speed,
+               turn_names[fsm_state(&turn_fsm)]);
+    pwm_cfg_print(&pwm.cfg);
+}
+
+static void CmdHz(const s32 *argv, u8 argc) {
+    if (pwm_cfg_console(&pwm, argv, argc, isr_prof_measured(&prof_tick)) == PWM_CMD_CHANGED)
+        UpdateRampRate();
+}
+
+// Curva in avanti: ogni ruota a speed per il suo fattore (1.0 = esterna)
+static void SetCurve(u8 speed, q8_8_t k_R, q8_8_t k_L) {
+    SetMotors(fix_scale8(speed, k_R), 1, fix_scale8(speed, k_L), 1);
+}
+
+// Nuovi obiettivi delle due ruote (dir 1 = avanti), registrati nel trace
+static void SetMotors(u8 spd_R, u8 dir_R, u8 spd_L, u8 dir_L) {
+    motor_ramp_set(&ramp_R, spd_R, dir_R);
+    motor_ramp_set(&ramp_L, spd_L, dir_L);
+    trace_log(TR_SETPOINT, spd_R, (u16)spd_L | ((u16)(dir_R & 1) << 8) | ((u16)(dir_L & 1) << 9));
+}
+
+// Consegna un comando alla macchina delle frecce.
+// La macchina gira solo nel contesto del main (comandi e lavoro
+// differito), quindi non serve disabilitare gli interrupt.
+static void SetTurnSignal(turn_event_t ev) {
+    u8 old = fsm_state(&turn_fsm);
+
+    fsm_dispatch(&turn_fsm, ev);
+    if (fsm_state(&turn_fsm) != old)
+        trace_log(TR_TURN, fsm_state(&turn_fsm), old);
+}
+
+// Lavoro differito del timer delle frecce (eseguito con interrupt abilitati)
+static void BlinkWork(u32 arg) {
+    // Inverte lo stato (se acceso spegne, se spento accende)
+    blink_state = !blink_state;
+    fsm_dispatch(&turn_fsm, EV_BLINK); // Aggiorna i LED
+}
+
+// --- SETUP INIZIALE DEI TIMER ---
+static int SetupTimer(void) {
     // Configura TIMER 1 (Frecce)
     XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_BLINK, 0);
     XTmrCtr_SetLoadReg(TMRCTR_BASEADDR, TIMER_BLINK, BLINK_PERIOD); // Imposta velocità bassa
@@ -230,24 +454,26 @@ int SetupTimer(void) {
     XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_BLINK,
         XTC_CSR_AUTO_RELOAD_MASK | XTC_CSR_ENABLE_INT_MASK | XTC_CSR_DOWN_COUNT_MASK);
 
-    // Avvia entrambi i timer
-    XTmrCtr_Enable(TMRCTR_BASEADDR, TIMER_PWM);
+    // Configura e avvia TIMER 0 (Motori): velocità alta, automatico e
+    // conto alla rovescia. Frequenza e risoluzione validate contro i cicli
+    // misurati del tick motori.
+    pwm_rt_init(&pwm, TMRCTR_BASEADDR, TIMER_PWM, isr_prof_measured(&prof_tick));
+
+    // Avvia il timer delle frecce
     XTmrCtr_Enable(TMRCTR_BASEADDR, TIMER_BLINK);
 
-    // Dà il via libera al processore
-    microblaze_enable_interrupts();
+    // Abilita la linea del timer nel controller delle interruzioni
+    app_core_irq_enable(XPAR_AXI_TIMER_0_INTERRUPT_MASK);
     return XST_SUCCESS;
 }
 
-// --- LETTURA SERIALE ---
-u32 UART_RecvByte(UINTPTR BaseAddress) {
-    u32 status = XUartLite_GetStatusReg(BaseAddress);
-    // Se c'è un dato valido nella coda...
-    if (status & XUL_SR_RX_FIFO_VALID_DATA) {
-        u32 data = XUartLite_ReadReg(BaseAddress, XUL_RX_FIFO_OFFSET);
-        // Ignora i tasti "Invio"
-        if ((u8)data == 0x0D || (u8)data == 0x0A) return NO_DATA;
-        return data;
-    }
-    return NO_DATA;
+// Rampe alla stessa accelerazione qualunque sia il tick PWM
+static void UpdateRampRate(void) {
+    u32 tick_hz = pwm.cfg.tick_hz;
+    u16 rate = (tick_hz < 1000) ? 0xFFFF : RAMP_RATE_FULL_MS(RAMP_FULL_MS, tick_hz);
+
+    microblaze_disable_interrupts();
+    motor_ramp_set_rate(&ramp_R, rate);
+    motor_ramp_set_rate(&ramp_L, rate);
+    microblaze_enable_interrupts();
 }
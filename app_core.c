@@ -0,0 +1,212 @@
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xtmrctr_l.h"
+#include "xil_printf.h"
+#include "xuartlite_l.h"
+#include "mb_interface.h"
+#include "app_core.h"
+#include "timebase.h"
+#include "dpc.h"
+#include "gpio_shadow.h"
+#include "fixmath.h"
+#include "trace.h"
+#include "boot.h"
+#include "isr_budget.h"
+
+#ifndef SDT
+    #define UART_BASEADDR   XPAR_UARTLITE_0_BASEADDR
+#else
+    #define UART_BASEADDR   XPAR_XUARTLITE_0_BASEADDR
+#endif
+
+#define NO_DATA             0xFFFFFFFF
+
+// --- REGISTRI INTERRUZIONI (Interrupt Controller) ---
+static volatile int * MER  = (volatile int *)0x4120001C; // Master Enable Register
+static volatile int * IISR = (volatile int *)0x41200000; // Interrupt Status Register
+volatile int * IIAR = (volatile int *)0x4120000C; // Interrupt Acknowledge Register
+
+// Interrupt Enable Register, tramite copia ombra: ogni modulo accende
+// solo le sue linee senza leggere IER sul bus
+static gpio_shadow_t ier = GPIO_SHADOW_INIT(0x41200008);
+
+// --- STATO DEL NUCLEO ---
+static const app_module_t *const *app_table;
+static int app_count;
+static int app_index = -1;
+static const app_module_t *volatile current;
+
+// Modulo vuoto: attivo durante il cambio, non fa niente
+static void idle_isr(u32 pending) { }
+static const app_module_t app_idle = { "idle", NULL, NULL, idle_isr, NULL, NULL };
+
+void myISR(void) __attribute__((interrupt_handler));
+
+// --- GESTORE DELLE INTERRUZIONI ---
+// Unico per tutta l'immagine: legge IISR una volta e passa lo snapshot
+// al modulo attivo, che conferma (IIAR) le linee che ha gestito.
+void myISR(void)
+{
+    current->isr(*IISR);
+}
+
+// --- LINEE DELL'INTC ---
+// Il modulo accende le sue linee nell'init; al cambio il nucleo le spegne tutte
+void app_core_irq_enable(u32 mask)
+{
+    gpio_sh_set(&ier, mask);
+}
+
+// Ferma un contatore dell'AXI Timer e ne pulisce la richiesta di interrupt
+void app_core_timer_stop(UINTPTR base, u8 counter)
+{
+    XTmrCtr_SetControlStatusReg(base, counter, XTC_CSR_INT_OCCURED_MASK);
+}
+
+// --- LETTURA SERIALE ---
+static u32 app_core_recv_byte(void)
+{
+    u32 status = XUartLite_GetStatusReg(UART_BASEADDR);
+    // Se c'è un dato valido nella coda...
+    // Overrun: byte persi, il registratore tiene la storia fino a qui
+    if (status & XUL_SR_OVERRUN_ERROR)
+        trace_fault(TR_ERR_UART_OVERRUN, (u16)status);
+    if (status & XUL_SR_RX_FIFO_VALID_DATA) {
+        // Anche gli "Invio" (CR/LF): chiudono i comandi a parole (console.h)
+        return XUartLite_ReadReg(UART_BASEADDR, XUL_RX_FIFO_OFFSET);
+    }
+    return NO_DATA;
+}
+
+// --- CAMBIO DI MODULO ---
+// Ferma il modulo attivo (con gli interrupt della CPU spenti, dopo aver
+// eseguito il suo lavoro differito), installa il nuovo e lo avvia.
+// Il tempo dall'inizio alla fine dell'init viene misurato e stampato.
+int app_core_switch(int index)
+{
+    const app_module_t *next;
+    u64 t0, t1;
+    u32 us;
+    int status = XST_SUCCESS;
+
+    if (index < 0 || index >= app_count) {
+        xil_printf("App %d inesistente\r\n", index);
+        return XST_FAILURE;
+    }
+    next = app_table[index];
+    t0 = timebase_now();
+
+    microblaze_disable_interrupts();
+    dpc_run(); // Il lavoro accodato appartiene ancora al modulo vecchio
+    if (current->stop)
+        current->stop();
+    gpio_sh_write(&ier, 0);
+    *IIAR = 0xFFFFFFFF; // Scarta le richieste rimaste in sospeso
+    current = next;
+    app_index = index;
+    microblaze_enable_interrupts();
+
+    // Il modulo abilita le sue linee: da qui la ISR lo serve
+    if (next->init)
+        status = next->init();
+    boot_mark(BOOT_PH_APP);
+    trace_log(TR_APP, (u8)index, status != XST_SUCCESS);
+    if (status != XST_SUCCESS)
+        trace_fault(TR_ERR_APP_INIT, (u16)index);
+
+    t1 = timebase_now();
+    us = (u32)timebase_ticks_to_us(t1 - t0);
+
+    xil_printf("App %d: %s (cambio %d us, budget %d us) %s\r\n",
+               index, next->name, (int)us, APP_SWITCH_BUDGET_US,
+               (status != XST_SUCCESS) ? "ERRORE" :
+               (us > APP_SWITCH_BUDGET_US) ? "FAIL" : "OK");
+
+    return status;
+}
+
+static void app_core_list(void)
+{
+    int i;
+    for (i = 0; i < app_count; i++)
+        xil_printf("%c %d: %s\r\n", (i == app_index) ? '*' : ' ', i, app_table[i]->name);
+}
+
+// Comando del nucleo (il byte dopo '@'): 1 se era un comando
+static int app_core_command(u8 c)
+{
+    if (c >= '0' && c <= '9')
+        app_core_switch(c - '0');
+    else if (c == 'l')
+        app_core_list();
+    else if (c == 'b')
+        boot_print();
+    else if (c == 'x')
+        fixmath_bench();
+    else if (c == 'f')
+        trace_freeze(0);
+    else if (c == 't')
+        trace_dump();
+    else if (c == 'r')
+        trace_resume();
+    else
+        return 0;
+    return 1;
+}
+
+// --- AVVIO ---
+// Inizializza una sola volta ciò che è comune e avvia il primo modulo.
+// L'ordine è quello dell'avvio rapido (boot.h): prima le uscite sicure e
+// lo stack dipinto, poi quello che serve al primo modulo.
+// Il banco di prova (tools/bench) la chiama senza entrare nel loop.
+int app_core_start(const app_module_t *const *apps, int n_apps)
+{
+    // Uscite in stato sicuro e base dei tempi
+    boot_fast_start();
+
+    app_table = apps;
+    app_count = n_apps;
+    current = &app_idle;
+
+    // INTC (nessuna linea abilitata) e CPU
+    gpio_sh_write(&ier, 0);
+    *IIAR = 0xFFFFFFFF;
+    *MER = 0x3;
+    microblaze_enable_interrupts();
+    boot_mark(BOOT_PH_CORE);
+
+    return app_core_switch(0);
+}
+
+// --- LOOP PRINCIPALE ---
+// Avvia e poi gira per sempre: seriale, passo del modulo, lavoro differito.
+int app_core_run(const app_module_t *const *apps, int n_apps)
+{
+    u32 uart_input;
+    int prefix = 0;
+
+    if (app_core_start(apps, n_apps) != XST_SUCCESS)
+        return XST_FAILURE;
+
+    while (1) {
+        uart_input = app_core_recv_byte();
+        if (uart_input != NO_DATA) {
+            if (prefix) {
+                prefix = 0;
+                trace_log(TR_CORE, (u8)uart_input, 0);
+                if (app_core_command((u8)uart_input))
+                    boot_mark(BOOT_PH_CMD);
+            } else if ((u8)uart_input == APP_CMD_PREFIX) {
+                prefix = 1;
+            } else if (current->on_byte) {
+                // I comandi eseguiti li segna il modulo (boot.h)
+                current->on_byte((u8)uart_input);
+            }
+        }
+
+        if (current->step)
+            current->step();
+        dpc_run();
+    }
+    return XST_SUCCESS;
+}
@@ -0,0 +1,49 @@
+#ifndef APP_CORE_H
+#define APP_CORE_H
+
+#include "xil_types.h"
+
+// --- NUCLEO COMUNE E MODULI APPLICATIVI ---
+// Ogni programma (frecce, PWM RGB, rover, ...) è un modulo con i suoi
+// agganci init/step/isr. Il nucleo inizializza una sola volta quello che
+// hanno in comune (controller delle interruzioni, base dei tempi, stack,
+// interrupt della CPU), possiede la myISR e la lettura della seriale, e
+// passa il controllo al modulo attivo.
+//
+// Compilando con APP_SINGLE_IMAGE tutti i programmi finiscono in un'unica
+// immagine (app_main.c) e si sceglie il modulo da seriale con "@<n>".
+// Senza, ogni programma resta un eseguibile a sé (APP_STANDALONE_MAIN).
+
+typedef struct {
+    const char *name;
+    int  (*init)(void);         // Configura periferiche e stato, abilita le sue sorgenti
+    void (*step)(void);         // Un giro del loop principale (o NULL)
+    void (*isr)(u32 pending);   // Corpo della ISR, riceve lo snapshot di IISR
+    void (*on_byte)(u8 c);      // Byte ricevuto dalla seriale, CR/LF compresi (o NULL)
+    void (*stop)(void);         // Ferma timer, maschera sorgenti, uscite sicure
+} app_module_t;
+
+// Acknowledge dell'INTC: ogni modulo conferma le linee che ha gestito.
+// IER, MER e IISR sono del nucleo (app_core_irq_enable, snapshot nella myISR).
+extern volatile int * IIAR;
+
+// Comandi del nucleo: '@' seguito da una cifra (cambio modulo), da 'l'
+// (elenco), da 'b' (profilo di boot), da 'x' (benchmark di fixmath) o da
+// 'f', 't', 'r' (registratore di volo: congela, scarica, riprende)
+#define APP_CMD_PREFIX  '@'
+
+// Prototipi
+int  app_core_run(const app_module_t *const *apps, int n_apps);
+int  app_core_start(const app_module_t *const *apps, int n_apps);   // Avvio senza loop
+int  app_core_switch(int index);
+void app_core_irq_enable(u32 mask);
+void app_core_timer_stop(UINTPTR base, u8 counter);
+
+// main() di un programma compilato da solo
+#define APP_STANDALONE_MAIN(app) \
+    int main(void) { \
+        static const app_module_t *const apps_[] = { &(app) }; \
+        return app_core_run(apps_, 1); \
+    }
+
+#endif
@@ -0,0 +1,33 @@
+#include "app_core.h"
+
+// --- IMMAGINE UNICA ---
+// Tutti i programmi in un solo firmware, selezionabili da seriale:
+//   @l  elenco dei moduli (* = attivo)
+//   @<n> cambio di modulo, con il tempo di cambio misurato
+// Si compila con -DAPP_SINGLE_IMAGE insieme a tutti i sorgenti dei
+// programmi e dei moduli comuni (i main dei singoli programmi spariscono).
+#ifdef APP_SINGLE_IMAGE
+
+extern const app_module_t app_fsm;      // FSM.c
+extern const app_module_t app_pwm;      // PWM.c
+extern const app_module_t app_rgb;      // PWM&uart.c
+extern const app_module_t app_rover;    // Rover.c
+extern const app_module_t app_buttons;  // interrupts.c
+extern const app_module_t app_timer;    // timer.c
+
+// L'ordine dà il numero del comando "@<n>"; il primo parte all'accensione
+static const app_module_t *const apps[] = {
+    &app_fsm,
+    &app_pwm,
+    &app_rgb,
+    &app_rover,
+    &app_buttons,
+    &app_timer,
+};
+
+int main(void)
+{
+    return app_core_run(apps, sizeof(apps) / sizeof(apps[0]));
+}
+
+#endif
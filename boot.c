@@ -0,0 +1,63 @@
+#include "xparameters.h"
+#include "xil_printf.h"
+#include "boot.h"
+#include "stack_mon.h"
+
+// Uscite da mettere in sicurezza (stessi indirizzi dei programmi)
+#define BOOT_LEDS_DATA      0x40000000  // LED, canale 1
+#define BOOT_RGB_DATA       0x40000008  // LED RGB, canale 2 (attivi bassi)
+
+u64 boot_ts[BOOT_N_PHASES];
+volatile u8 boot_seen[BOOT_N_PHASES];
+
+static const char *const boot_names[BOOT_N_PHASES] = {
+    [BOOT_PH_CORE]     = "nucleo",
+    [BOOT_PH_APP]      = "primo modulo",
+    [BOOT_PH_PWM]      = "prima uscita PWM",
+    [BOOT_PH_CMD]      = "primo comando",
+};
+
+// --- AVVIO RAPIDO ---
+// Solo scritture a indirizzi costanti, nessuna lettura e nessuna chiamata
+// prima che le uscite siano sicure. Il dato va prima della direzione:
+// il pin diventa uscita già al livello giusto. Subito dopo, con gli
+// interrupt ancora spenti, la pittura dello stack: nessuna ISR può usarlo
+// prima che sia dipinto.
+void boot_fast_start(void)
+{
+#ifdef XPAR_GPIO_MOTORS_BASEADDR
+    *(volatile int *)(XPAR_GPIO_MOTORS_BASEADDR + 0x08) = 0x0; // Chip dei motori disabilitato
+    *(volatile int *)(XPAR_GPIO_MOTORS_BASEADDR + 0x0C) = 0x0;
+    *(volatile int *)(XPAR_GPIO_MOTORS_BASEADDR + 0x00) = 0x0; // PWM e direzione a zero
+    *(volatile int *)(XPAR_GPIO_MOTORS_BASEADDR + 0x04) = 0x0;
+#endif
+    *(volatile int *)BOOT_LEDS_DATA = 0x0;  // LED spenti
+    *(volatile int *)BOOT_RGB_DATA  = 0x7;  // RGB spenti
+
+    stack_paint();
+
+    // Da qui si misura
+    timebase_init();
+}
+
+// Stampa le fasi con l'istante dall'avvio e il tempo dalla fase precedente
+void boot_print(void)
+{
+    int i;
+    u64 prev = 0;
+
+    for (i = 0; i < BOOT_N_PHASES; i++) {
+        u32 t_us, d_us;
+
+        if (!boot_seen[i]) {
+            xil_printf("Boot: %s: non ancora\r\n", boot_names[i]);
+            continue;
+        }
+
+        t_us = (u32)timebase_ticks_to_us(boot_ts[i]);
+        d_us = (u32)timebase_ticks_to_us(boot_ts[i] - prev);
+        prev = boot_ts[i];
+
+        xil_printf("Boot: %s: %d us (+%d us)\r\n", boot_names[i], (int)t_us, (int)d_us);
+    }
+}
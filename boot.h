@@ -0,0 +1,50 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "xil_types.h"
+#include "timebase.h"
+
+// --- AVVIO RAPIDO E PROFILO DI BOOT ---
+// boot_fast_start() è la prima cosa che fa il nucleo: porta le uscite
+// pericolose in stato sicuro (motori disabilitati, LED spenti) con poche
+// scritture sul bus, prima di qualsiasi stampa o inizializzazione lenta,
+// poi dipinge lo stack (stack_mon.h) e avvia la base dei tempi. Il resto
+// (banner, stampe) viene dopo che il primo modulo è partito.
+//
+// Ogni fase del boot registra il suo istante una volta sola. Lo zero è
+// l'avvio della base dei tempi, cioè le prime istruzioni del main con le
+// uscite già sicure e lo stack dipinto: il tempo passato nel crt0
+// (azzeramento del .bss, costruttori) non si vede, il banco su QEMU
+// (tools/bench) lo conta dal reset. La tabella si stampa con il comando "@b".
+// Non ci sono budget in tempo: le fasi fino al primo modulo le misura il
+// banco (casi avvio.*, confrontati con la sua baseline).
+//
+// BOOT_PH_CMD lo segnano i percorsi che eseguono davvero un comando (tasto
+// riconosciuto, parola completa, comando del nucleo), non ogni byte.
+
+typedef enum {
+    BOOT_PH_CORE,       // INTC e interrupt della CPU pronti
+    BOOT_PH_APP,        // Init del primo modulo finito
+    BOOT_PH_PWM,        // Prima uscita PWM scritta dalla ISR
+    BOOT_PH_CMD,        // Primo comando eseguito dalla seriale
+    BOOT_N_PHASES
+} boot_phase_t;
+
+extern u64 boot_ts[BOOT_N_PHASES];
+extern volatile u8 boot_seen[BOOT_N_PHASES];
+
+// Registra l'istante della fase solo la prima volta: dopo costa un
+// confronto, quindi si può lasciare nella ISR del PWM
+static inline void boot_mark(boot_phase_t ph)
+{
+    if (!boot_seen[ph]) {
+        boot_ts[ph] = timebase_now();
+        boot_seen[ph] = 1;
+    }
+}
+
+// Prototipi
+void boot_fast_start(void);
+void boot_print(void);
+
+#endif
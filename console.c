@@ -0,0 +1,195 @@
+#include "xil_printf.h"
+#include "console.h"
+#include "isr_budget.h"
+#include "trace.h"
+#include "boot.h"
+
+// Stati della macchina
+#define CON_WORD    0   // Lettere del nome (len == 0: inizio parola)
+#define CON_ARGS    1   // Argomenti di un comando riconosciuto
+#define CON_BAD     2   // Argomenti non validi: si scarta fino a fine riga
+
+// Cosa fare dopo l'analisi del byte (fuori dalla misura dei cicli)
+#define CON_RUN_NONE    0
+#define CON_RUN_CMD     1
+#define CON_RUN_USAGE   2
+
+void console_init(console_t *con, const console_cmd_t *cmds, u8 n_cmds, console_legacy_t legacy)
+{
+    con->cmds = cmds;
+    con->n_cmds = n_cmds;
+    con->legacy = legacy;
+    con->state = CON_WORD;
+    con->len = 0;
+    con->word = 0;
+    con->cand = 0;
+    con->cmd = 0;
+    isr_prof_reset(&con->prof);
+}
+
+// Comandi il cui nome ha 'c' in posizione 'pos', tra quelli in 'cand'
+static u32 console_match(const console_t *con, u32 cand, u8 pos, u8 c)
+{
+    u32 next = 0, bit = 1;
+    u8 i;
+
+    for (i = 0; i < con->n_cmds; i++, bit <<= 1)
+        if ((cand & bit) && con->cmds[i].name[pos] == c)
+            next |= bit;
+    return next;
+}
+
+// Primo comando in 'cand' lungo esattamente 'len' lettere, o n_cmds
+static u8 console_exact(const console_t *con, u32 cand, u8 len)
+{
+    u32 bit = 1;
+    u8 i;
+
+    for (i = 0; i < con->n_cmds; i++, bit <<= 1)
+        if ((cand & bit) && con->cmds[i].name[len] == '\0')
+            return i;
+    return con->n_cmds;
+}
+
+// Chiude il numero in corso e lo aggiunge agli argomenti
+static void console_push_num(console_t *con)
+{
+    if (con->digits == 0 || con->argc >= CON_MAX_ARGS) {
+        con->state = CON_BAD;
+        return;
+    }
+    con->argv[con->argc++] = con->neg ? -con->num : con->num;
+    con->num = 0;
+    con->neg = 0;
+    con->digits = 0;
+}
+
+static void console_start_args(console_t *con, u8 cmd)
+{
+    con->state = CON_ARGS;
+    con->cmd = cmd;
+    con->argc = 0;
+    con->num = 0;
+    con->neg = 0;
+    con->digits = 0;
+}
+
+void console_feed(console_t *con, u8 c)
+{
+    u32 flush_word = 0;     // Lettere in sospeso da consegnare al gestore
+    u8  flush_n = 0;
+    u8  forward = 0;        // Anche 'c' va al gestore
+    u8  run = CON_RUN_NONE;
+    u8  cmd = con->cmd;
+    u8  eol = (c == '\r' || c == '\n');
+    u8  space = (c == ' ' || c == '\t');
+    u8  i;
+
+    ISR_PROF_BEGIN(t_byte);
+
+    switch (con->state) {
+    case CON_WORD:
+        if (eol || space) {
+            if (con->len == 0)
+                break;  // Separatori ripetuti o riga vuota
+            i = con->cand ? console_exact(con, con->cand, con->len) : con->n_cmds;
+            if (i < con->n_cmds) {
+                // Parola riconosciuta: a fine riga parte subito, dopo lo spazio arrivano gli argomenti
+                console_start_args(con, i);
+                if (eol) {
+                    cmd = i;
+                    run = (con->cmds[i].min_args == 0) ? CON_RUN_CMD : CON_RUN_USAGE;
+                    con->state = CON_WORD;
+                }
+            } else if (con->cand) {
+                flush_word = con->word;
+                flush_n = con->len - 1;
+            }
+            con->len = 0;
+            con->cand = 0;
+        } else if (con->len == 0) {
+            // Prima lettera: al gestore subito, in ogni caso. Se nessun
+            // comando inizia così la parola non parte: il byte dopo è di
+            // nuovo una prima lettera ("1rgb ..." esegue "rgb")
+            forward = 1;
+            con->word = c;
+            con->cand = console_match(con, 0xFFFFFFFFU, 0, c);
+            con->len = con->cand ? 1 : 0;
+        } else if (con->cand) {
+            u32 next = (con->len < CON_WORD_MAX) ? console_match(con, con->cand, con->len, c) : 0;
+            if (next) {
+                // Può ancora essere un comando: la lettera resta in sospeso
+                con->word = (con->word << 8) | c;
+                con->len++;
+                con->cand = next;
+            } else {
+                // Non è un comando: le lettere in sospeso e questa al gestore,
+                // e il byte dopo inizia una parola nuova
+                flush_word = con->word;
+                flush_n = con->len - 1;
+                forward = 1;
+                con->len = 0;
+                con->cand = 0;
+            }
+        } else {
+            forward = 1;
+            con->len = 0;
+        }
+        break;
+
+    case CON_ARGS:
+        if (c >= '0' && c <= '9') {
+            if (con->num <= (CON_NUM_MAX - 9) / 10)
+                con->num = (con->num << 3) + (con->num << 1) + (c - '0');   // x10 senza moltiplicazione
+            else
+                con->num = CON_NUM_MAX;
+            con->digits++;
+        } else if (c == '-' && con->digits == 0 && !con->neg) {
+            con->neg = 1;
+        } else if (space || eol) {
+            if (con->digits || con->neg)
+                console_push_num(con);
+            if (eol) {
+                run = (con->state == CON_ARGS &&
+                       con->argc >= con->cmds[cmd].min_args &&
+                       con->argc <= con->cmds[cmd].max_args) ? CON_RUN_CMD : CON_RUN_USAGE;
+                con->state = CON_WORD;
+            }
+        } else {
+            con->state = CON_BAD;
+        }
+        break;
+
+    default: // CON_BAD
+        if (eol) {
+            run = CON_RUN_USAGE;
+            con->state = CON_WORD;
+        }
+        break;
+    }
+
+    ISR_PROF_END(con->prof, t_byte);
+
+    // Consegne al gestore e comandi, nell'ordine in cui sono arrivati i byte
+    if (con->legacy) {
+        while (flush_n) {
+            flush_n--;
+            con->legacy((u8)(flush_word >> (flush_n << 3)));
+        }
+        if (forward)
+            con->legacy(c);
+    }
+    if (run == CON_RUN_CMD) {
+        trace_log(TR_CMD, cmd, con->argc);
+        boot_mark(BOOT_PH_CMD);
+        con->cmds[cmd].fn(con->argv, con->argc);
+    }
+    else if (run == CON_RUN_USAGE)
+        xil_printf("Uso: %s\r\n", con->cmds[cmd].usage);
+}
+
+// Cicli per byte dell'analisi rispetto al budget
+void console_report(const console_t *con)
+{
+    isr_prof_report("console", &con->prof, LOOP_BUDGET_CONSOLE_BYTE);
+}
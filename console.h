@@ -0,0 +1,75 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "xil_types.h"
+#include "isr_prof.h"
+
+// --- CONSOLE A PAROLE DALLA SERIALE ---
+// Comandi leggibili con argomenti numerici, per esempio
+//   rgb 255 128 0      vel 120 -80      info      hz 20000 3
+// analizzati un byte alla volta da una macchina a stati: niente buffer di
+// riga, niente sscanf, niente heap. La parola si tiene impacchettata in
+// un u32 (massimo CON_WORD_MAX lettere), ogni numero si accumula man mano
+// che arrivano le cifre e il comando parte a fine riga (CR o LF).
+// Ogni byte costa un tempo costante: al massimo un giro sulla tabella dei
+// comandi del modulo (la misura è in con->prof, con ISR_PROFILE).
+//
+// I comandi a un carattere di sempre continuano a funzionare e partono
+// subito, senza Invio: ogni byte che non fa parte di un comando a parole
+// passa al gestore 'legacy' del modulo. In dettaglio:
+//   - la prima lettera di ogni parola va sempre subito al gestore, anche
+//     se può iniziare un comando: per questo nessun comando a parole deve
+//     iniziare con un tasto del modulo (nel rover "vel", non "spd": la 's'
+//     fermerebbe i motori);
+//   - le lettere successive restano in sospeso finché la parola può
+//     ancora diventare un comando; se non lo diventa ("vx", "infx", fine
+//     riga) arrivano al gestore tutte insieme, nell'ordine, e il byte dopo
+//     inizia una parola nuova (anche dopo un tasto che nessun comando ha
+//     come prima lettera: "1rgb 0 0 255" dà il tasto '1' e poi "rgb");
+//   - dopo lo spazio che segue un comando riconosciuto, tutto fino a fine
+//     riga è argomento e non va al gestore.
+// Quindi un tasto arriva in ritardo solo se segue la prima lettera di un
+// comando a parole, che da sola non è un tasto: i tasti battuti da soli
+// partono sempre subito.
+//
+// Prova al banco senza scheda: tools/console_sim.sh (righe di esempio e
+// tempo per byte contro LOOP_BUDGET_CONSOLE_BYTE).
+
+#define CON_WORD_MAX    4       // Lettere per parola (stanno in un u32)
+#define CON_MAX_ARGS    4
+#define CON_NUM_MAX     99999   // Gli argomenti saturano qui
+
+typedef void (*console_fn_t)(const s32 *argv, u8 argc);
+typedef void (*console_legacy_t)(u8 c);
+
+typedef struct {
+    const char *name;       // Parola, minuscola, al massimo CON_WORD_MAX lettere
+    u8 min_args;
+    u8 max_args;
+    console_fn_t fn;
+    const char *usage;      // Stampato se gli argomenti non vanno bene
+} console_cmd_t;
+
+typedef struct {
+    const console_cmd_t *cmds;
+    u8  n_cmds;
+    console_legacy_t legacy;
+    u8  state;
+    u8  len;                // Lettere della parola in corso
+    u32 word;               // Lettere impacchettate, l'ultima nel byte basso
+    u32 cand;               // Comandi ancora compatibili con la parola (bit i)
+    u8  cmd;                // Comando riconosciuto
+    u8  argc;
+    u8  neg;                // Segno meno letto
+    u8  digits;             // Cifre del numero in corso
+    s32 num;
+    s32 argv[CON_MAX_ARGS];
+    isr_prof_t prof;        // Cicli per byte dell'analisi (comandi esclusi)
+} console_t;
+
+// Prototipi
+void console_init(console_t *con, const console_cmd_t *cmds, u8 n_cmds, console_legacy_t legacy);
+void console_feed(console_t *con, u8 c);
+void console_report(const console_t *con);
+
+#endif
@@ -0,0 +1,95 @@
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "dpc.h"
+#include "timebase.h"
+#include "trace.h"
+
+typedef struct {
+    dpc_fn_t fn;
+    u32 arg;
+    u32 posted_at;      // timebase_now32() al momento dell'accodamento
+} dpc_item_t;
+
+static dpc_item_t queue[DPC_QUEUE_SIZE];
+static volatile u32 head = 0;   // Scritto solo dalla ISR
+static volatile u32 tail = 0;   // Scritto solo dal main
+
+static volatile u32 cnt_posted = 0;
+static volatile u32 cnt_dropped = 0;
+static volatile u32 max_depth = 0;
+static u32 cnt_executed = 0;
+static u32 last_latency = 0;
+static u32 max_latency = 0;
+
+// Accoda un elemento. Costo costante: nessun ciclo, nessuna divisione.
+int dpc_post(dpc_fn_t fn, u32 arg)
+{
+    u32 h = head;
+    u32 depth = h - tail;
+
+    if (depth >= DPC_QUEUE_SIZE) {
+        cnt_dropped++;
+        trace_fault(TR_ERR_DPC_FULL, (u16)(UINTPTR)fn); // Dettaglio: indirizzo della funzione persa
+        return XST_FAILURE;
+    }
+
+    dpc_item_t *it = &queue[h & (DPC_QUEUE_SIZE - 1)];
+    it->fn = fn;
+    it->arg = arg;
+    it->posted_at = timebase_now32();
+
+    // queue[] non è volatile: senza barriera il compilatore potrebbe
+    // spostare le scritture dell'elemento dopo la pubblicazione
+    __asm__ volatile ("" ::: "memory");
+    head = h + 1; // Pubblica l'elemento solo dopo averlo scritto
+    cnt_posted++;
+    if (depth + 1 > max_depth) max_depth = depth + 1;
+    return XST_SUCCESS;
+}
+
+// Esegue tutto il lavoro in attesa. Restituisce quanti elementi ha eseguito.
+int dpc_run(void)
+{
+    int n = 0;
+
+    while (tail != head) {
+        dpc_item_t it = queue[tail & (DPC_QUEUE_SIZE - 1)];
+        // La copia deve essere finita prima di liberare la cella: dopo la
+        // ISR può riscriverla
+        __asm__ volatile ("" ::: "memory");
+        tail = tail + 1; // Libera la cella prima di eseguire
+
+        last_latency = timebase_now32() - it.posted_at;
+        if (last_latency > max_latency) max_latency = last_latency;
+
+        it.fn(it.arg);
+        cnt_executed++;
+        n++;
+    }
+    return n;
+}
+
+void dpc_get_stats(dpc_stats_t *stats)
+{
+    stats->posted = cnt_posted;
+    stats->executed = cnt_executed;
+    stats->dropped = cnt_dropped;
+    stats->depth = head - tail;
+    stats->max_depth = max_depth;
+    stats->last_latency = last_latency;
+    stats->max_latency = max_latency;
+}
+
+// Stampa le statistiche sulla seriale (latenze in microsecondi)
+void dpc_print_stats(void)
+{
+    dpc_stats_t st;
+    dpc_get_stats(&st);
+
+    xil_printf("DPC: accodati %d eseguiti %d persi %d\r\n",
+               (int)st.posted, (int)st.executed, (int)st.dropped);
+    xil_printf("DPC: coda %d (max %d) latenza %d us (max %d us)\r\n",
+               (int)st.depth, (int)st.max_depth,
+               (int)timebase_ticks_to_us(st.last_latency),
+               (int)timebase_ticks_to_us(st.max_latency));
+}
@@ -0,0 +1,38 @@
+#ifndef DPC_H
+#define DPC_H
+
+#include "xil_types.h"
+
+// --- LAVORO DIFFERITO (bottom-half) ---
+// La ISR fa solo il lavoro urgente (ack, PWM) e accoda il resto come
+// piccoli elementi di lavoro. Il loop principale li esegue con gli
+// interrupt abilitati, dopo che la ISR è tornata: il tick PWM può
+// interromperli in qualsiasi momento, quindi il percorso PWM resta a
+// tempo costante anche se il lavoro lento cresce.
+//
+// Un solo produttore (la ISR) e un solo consumatore (il main):
+// la coda circolare non ha bisogno di lock.
+
+#ifndef DPC_QUEUE_SIZE
+#define DPC_QUEUE_SIZE  16      // Deve essere una potenza di 2
+#endif
+
+typedef void (*dpc_fn_t)(u32 arg);
+
+typedef struct {
+    u32 posted;         // Elementi accodati
+    u32 executed;       // Elementi eseguiti
+    u32 dropped;        // Elementi persi a coda piena
+    u32 depth;          // Elementi in attesa adesso
+    u32 max_depth;      // Massima profondità raggiunta
+    u32 last_latency;   // Tick tra accodamento ed esecuzione (ultimo)
+    u32 max_latency;    // Tick tra accodamento ed esecuzione (peggiore)
+} dpc_stats_t;
+
+// Prototipi
+int  dpc_post(dpc_fn_t fn, u32 arg);    // Dalla ISR (o a interrupt disabilitati)
+int  dpc_run(void);                     // Dal loop principale
+void dpc_get_stats(dpc_stats_t *stats);
+void dpc_print_stats(void);
+
+#endif
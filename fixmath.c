@@ -0,0 +1,139 @@
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "fixmath.h"
+#include "timebase.h"
+
+// --- TABELLE ---
+// sin(i * 90° / 64) in Q1.15, i = 0..64 (l'ultimo punto serve all'interpolazione)
+const s16 fix_sin_table[65] = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+     6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+// round(255 * (i / 255)^2.2): la luminosità percepita diventa lineare nel duty
+const u8 fix_gamma_table[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+// --- BENCHMARK SUL TARGET ---
+// Confronta ogni operazione con la scrittura "ingenua" in C (64 bit,
+// divisione, che senza le unità hardware finiscono in libgcc) e ne misura
+// l'errore massimo in LSB. I cicli sono la media su FIX_BENCH_N chiamate,
+// loop compreso. Si lancia dal nucleo con "@x": ricompilando per un
+// MicroBlaze con unità diverse si confrontano le varianti.
+#define FIX_BENCH_N     64      // Potenza di due: la media è uno shift
+#define FIX_ERR_MAX     1       // LSB ammessi (troncamento verso zero)
+
+static q16_16_t bench_a[FIX_BENCH_N], bench_b[FIX_BENCH_N];
+static volatile s32 fix_sink;   // Impedisce al compilatore di eliminare i loop
+
+#define FIX_BENCH(expr, cycles) do { \
+        u32 t0_ = timebase_now32(); \
+        for (i = 0; i < FIX_BENCH_N; i++) \
+            fix_sink = (expr); \
+        (cycles) = (timebase_now32() - t0_) / FIX_BENCH_N; \
+    } while (0)
+
+#define FIX_ERR(got, ref, err) do { \
+        for (i = 0; i < FIX_BENCH_N; i++) { \
+            s32 d_ = (s32)(got) - (s32)(ref); \
+            if (d_ < 0) d_ = -d_; \
+            if ((u32)d_ > (err)) (err) = (u32)d_; \
+        } \
+    } while (0)
+
+static void fix_bench_line(const char *name, u32 fix, u32 ref, u32 err)
+{
+    if (ref)
+        xil_printf("%s\t%d\t%d\t%d\r\n", name, (int)fix, (int)ref, (int)err);
+    else
+        xil_printf("%s\t%d\t--\t--\r\n", name, (int)fix);
+}
+
+int fixmath_bench(void)
+{
+    u32 seed = 12345, fix, ref, err, worst = 0;
+    int i;
+
+    // Ingressi ripetibili: a in +-256.0, b in +-[1.0, 256.0] (niente saturazioni)
+    for (i = 0; i < FIX_BENCH_N; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        bench_a[i] = (q16_16_t)(seed >> 7) - (q16_16_t)0x01000000;
+        seed = seed * 1664525U + 1013904223U;
+        bench_b[i] = (q16_16_t)((seed >> 8) | FIX_Q16_ONE);
+        if (seed & 0x80000000U) bench_b[i] = -bench_b[i];
+    }
+
+    xil_printf("fixmath: MUL=%d DIV=%d BARREL=%d FPU=%d\r\n",
+               FIX_HW_MUL, FIX_HW_DIV, FIX_HW_BARREL, FIX_HW_FPU);
+    xil_printf("op\tfix\tC\terr (cicli, LSB)\r\n");
+
+    FIX_BENCH(q16_mul(bench_a[i], bench_b[i] >> 8), fix);
+    FIX_BENCH((s32)(((s64)bench_a[i] * (bench_b[i] >> 8)) >> 16), ref);
+    err = 0;
+    FIX_ERR(q16_mul(bench_a[i], bench_b[i] >> 8),
+            (((s64)bench_a[i] * (bench_b[i] >> 8)) >> 16), err);
+    fix_bench_line("q16_mul", fix, ref, err);
+    if (err > worst) worst = err;
+
+    FIX_BENCH(q16_div(bench_a[i], bench_b[i]), fix);
+    FIX_BENCH((s32)(((s64)bench_a[i] << 16) / bench_b[i]), ref);
+    err = 0;
+    FIX_ERR(q16_div(bench_a[i], bench_b[i]), (((s64)bench_a[i] << 16) / bench_b[i]), err);
+    fix_bench_line("q16_div", fix, ref, err);
+    if (err > worst) worst = err;
+
+    FIX_BENCH(q16_recip(bench_b[i]), fix);
+    FIX_BENCH((s32)(((s64)1 << 32) / bench_b[i]), ref);
+    err = 0;
+    FIX_ERR(q16_recip(bench_b[i]), (((s64)1 << 32) / bench_b[i]), err);
+    fix_bench_line("recip", fix, ref, err);
+    if (err > worst) worst = err;
+
+    FIX_BENCH(q8_mul((q8_8_t)(bench_a[i] >> 12), (q8_8_t)(bench_b[i] >> 12)), fix);
+    FIX_BENCH((s16)(((s32)(q8_8_t)(bench_a[i] >> 12) * (q8_8_t)(bench_b[i] >> 12)) >> 8), ref);
+    err = 0;
+    FIX_ERR(q8_mul((q8_8_t)(bench_a[i] >> 12), (q8_8_t)(bench_b[i] >> 12)),
+            (((s32)(q8_8_t)(bench_a[i] >> 12) * (q8_8_t)(bench_b[i] >> 12)) >> 8), err);
+    fix_bench_line("q8_mul", fix, ref, err);
+    if (err > worst) worst = err;
+
+    FIX_BENCH(fix_scale8((u8)bench_a[i], (q8_8_t)(bench_b[i] >> 16)), fix);
+    FIX_BENCH((s32)((((u32)(u8)bench_a[i] * (u32)(bench_b[i] >> 16) + 0x80) >> 8) > 255 ? 255 :
+                    (((u32)(u8)bench_a[i] * (u32)(bench_b[i] >> 16) + 0x80) >> 8)), ref);
+    fix_bench_line("scale8", fix, ref, 0);
+
+    FIX_BENCH(fix_sin((u16)bench_a[i]), fix);
+    fix_bench_line("sin", fix, 0, 0);
+
+    FIX_BENCH(fix_gamma8((u8)bench_a[i]), fix);
+    fix_bench_line("gamma8", fix, 0, 0);
+
+    if (worst > FIX_ERR_MAX) {
+        xil_printf("fixmath: errore %d LSB FAIL\r\n", (int)worst);
+        return XST_FAILURE;
+    }
+    return XST_SUCCESS;
+}
@@ -0,0 +1,367 @@
+#ifndef FIXMATH_H
+#define FIXMATH_H
+
+#include "xil_types.h"
+#include "xparameters.h"
+
+// --- MATEMATICA IN VIRGOLA FISSA (Q8.8 e Q16.16) ---
+// Interpolazione dei colori, miscelazione delle velocità e anelli di
+// controllo senza float e senza chiamate alle routine lente di libgcc
+// (__mulsi3, __divsi3, __muldi3, soft-float), quindi utilizzabili anche
+// dalle ISR. Tutte le operazioni saturano invece di andare in overflow.
+//
+// Il codice si specializza a compile-time sulle unità che xparameters.h
+// dichiara per il MicroBlaze del block design:
+//   XPAR_MICROBLAZE_USE_HW_MUL   1 = mul 32x32, 2 = anche mulh (prodotti a 64 bit)
+//   XPAR_MICROBLAZE_USE_DIV      divisore hardware (idiv)
+//   XPAR_MICROBLAZE_USE_BARREL   barrel shifter (shift di n bit in un ciclo)
+//   XPAR_MICROBLAZE_USE_FPU      FPU (conversioni da/verso float)
+// Le scelte si possono forzare definendo prima FIX_HW_MUL, FIX_HW_DIV,
+// FIX_HW_BARREL o FIX_HW_FPU (per esempio per confrontare le varianti).
+//
+// Senza moltiplicatore: shift-and-add sui 16 bit, mai 32x32.
+// Senza divisore: divisione a shift e sottrazione limitata ai bit utili.
+// Senza barrel shifter: le mezze parole si prendono dalla memoria invece
+// di fare 16 shift da un bit.
+
+#ifndef FIX_HW_MUL
+#if defined(XPAR_MICROBLAZE_USE_HW_MUL) && (XPAR_MICROBLAZE_USE_HW_MUL > 0)
+#define FIX_HW_MUL      XPAR_MICROBLAZE_USE_HW_MUL
+#else
+#define FIX_HW_MUL      0
+#endif
+#endif
+
+#ifndef FIX_HW_DIV
+#if defined(XPAR_MICROBLAZE_USE_DIV) && XPAR_MICROBLAZE_USE_DIV
+#define FIX_HW_DIV      1
+#else
+#define FIX_HW_DIV      0
+#endif
+#endif
+
+#ifndef FIX_HW_BARREL
+#if defined(XPAR_MICROBLAZE_USE_BARREL) && XPAR_MICROBLAZE_USE_BARREL
+#define FIX_HW_BARREL   1
+#else
+#define FIX_HW_BARREL   0
+#endif
+#endif
+
+#ifndef FIX_HW_FPU
+#if defined(XPAR_MICROBLAZE_USE_FPU) && XPAR_MICROBLAZE_USE_FPU
+#define FIX_HW_FPU      1
+#else
+#define FIX_HW_FPU      0
+#endif
+#endif
+
+typedef s16 q8_8_t;
+typedef s32 q16_16_t;
+
+#define FIX_Q8_ONE      ((q8_8_t)0x0100)
+#define FIX_Q8_MAX      ((q8_8_t)0x7FFF)
+#define FIX_Q8_MIN      ((q8_8_t)-0x8000)
+#define FIX_Q16_ONE     ((q16_16_t)0x00010000)
+#define FIX_Q16_MAX     ((q16_16_t)0x7FFFFFFF)
+#define FIX_Q16_MIN     ((q16_16_t)(-0x7FFFFFFF - 1))
+
+// Costanti da letterali reali, calcolate dal compilatore (nessun float a runtime)
+#define FIX_Q8(x)       ((q8_8_t)((x) * 256.0 + (((x) >= 0) ? 0.5 : -0.5)))
+#define FIX_Q16(x)      ((q16_16_t)((x) * 65536.0 + (((x) >= 0) ? 0.5 : -0.5)))
+
+// Angoli: un giro completo = 65536 (u16 che gira da solo)
+#define FIX_ANGLE_DEG(d) ((u16)((d) * 65536.0 / 360.0 + 0.5))
+
+// --- MEZZE PAROLE ---
+// Con il barrel shifter x >> 16 costa un'istruzione; senza, sono 16 shift
+// da un bit e conviene passare dalla memoria (MicroBlaze AXI è little-endian).
+typedef union { u32 w; u16 h[2]; } fix_w32_t;
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define FIX_H_LO 1
+#define FIX_H_HI 0
+#else
+#define FIX_H_LO 0
+#define FIX_H_HI 1
+#endif
+
+static inline u16 fix_hi16(u32 x)
+{
+#if FIX_HW_BARREL
+    return (u16)(x >> 16);
+#else
+    fix_w32_t u;
+    u.w = x;
+    return u.h[FIX_H_HI];
+#endif
+}
+
+static inline u32 fix_shl16(u16 x)
+{
+#if FIX_HW_BARREL
+    return (u32)x << 16;
+#else
+    fix_w32_t u;
+    u.h[FIX_H_LO] = 0;
+    u.h[FIX_H_HI] = x;
+    return u.w;
+#endif
+}
+
+// --- MOLTIPLICAZIONE E DIVISIONE INTERE ---
+// 16x16 -> 32 senza segno
+static inline u32 fix_umul16(u16 a, u16 b)
+{
+#if FIX_HW_MUL
+    return (u32)a * b;
+#else
+    u32 acc = 0, aa = a;
+    while (b) {
+        if (b & 1) acc += aa;
+        aa <<= 1;
+        b >>= 1;
+    }
+    return acc;
+#endif
+}
+
+// 32 / 32 senza segno (d == 0 satura)
+static inline u32 fix_udiv32(u32 n, u32 d)
+{
+#if FIX_HW_DIV
+    return d ? n / d : 0xFFFFFFFF;
+#else
+    u32 q = 0, bit = 1;
+
+    if (d == 0) return 0xFFFFFFFF;
+    // Allinea il divisore al dividendo: solo i bit utili del quoziente
+    while (d < n && !(d & 0x80000000)) { d <<= 1; bit <<= 1; }
+    while (bit) {
+        if (n >= d) { n -= d; q |= bit; }
+        d >>= 1;
+        bit >>= 1;
+    }
+    return q;
+#endif
+}
+
+// Come fix_udiv32, con il resto (d != 0)
+static inline u32 fix_udivmod32(u32 n, u32 d, u32 *rem)
+{
+#if FIX_HW_DIV && FIX_HW_MUL
+    u32 q = n / d;
+    *rem = n - q * d;
+    return q;
+#else
+    u32 q = 0, bit = 1;
+
+    while (d < n && !(d & 0x80000000)) { d <<= 1; bit <<= 1; }
+    while (bit) {
+        if (n >= d) { n -= d; q |= bit; }
+        d >>= 1;
+        bit >>= 1;
+    }
+    *rem = n;
+    return q;
+#endif
+}
+
+// --- Q8.8 ---
+static inline q8_8_t q8_sat(s32 x)
+{
+    if (x > FIX_Q8_MAX) return FIX_Q8_MAX;
+    if (x < FIX_Q8_MIN) return FIX_Q8_MIN;
+    return (q8_8_t)x;
+}
+
+static inline q8_8_t q8_add(q8_8_t a, q8_8_t b) { return q8_sat((s32)a + b); }
+static inline q8_8_t q8_sub(q8_8_t a, q8_8_t b) { return q8_sat((s32)a - b); }
+
+static inline q8_8_t q8_mul(q8_8_t a, q8_8_t b)
+{
+    u16 ua = (a < 0) ? (u16)-a : (u16)a;
+    u16 ub = (b < 0) ? (u16)-b : (u16)b;
+    s32 p = (s32)(fix_umul16(ua, ub) >> 8);
+    return q8_sat(((a ^ b) < 0) ? -p : p);
+}
+
+// --- Q16.16 ---
+static inline q16_16_t q16_add(q16_16_t a, q16_16_t b)
+{
+    q16_16_t r = (q16_16_t)((u32)a + (u32)b);
+    if (((a ^ r) & (b ^ r)) < 0)    // Segni uguali in ingresso, diverso in uscita
+        r = (a < 0) ? FIX_Q16_MIN : FIX_Q16_MAX;
+    return r;
+}
+
+static inline q16_16_t q16_sub(q16_16_t a, q16_16_t b)
+{
+    q16_16_t r = (q16_16_t)((u32)a - (u32)b);
+    if (((a ^ b) & (a ^ r)) < 0)
+        r = (a < 0) ? FIX_Q16_MIN : FIX_Q16_MAX;
+    return r;
+}
+
+// Modulo con segno applicato e saturazione al campo Q16.16
+static inline q16_16_t q16_sign_sat(u32 mag, int neg, int ovf)
+{
+    if (neg) {
+        if (ovf || mag > 0x80000000U) return FIX_Q16_MIN;
+        return (q16_16_t)(0U - mag);
+    }
+    if (ovf || mag > 0x7FFFFFFFU) return FIX_Q16_MAX;
+    return (q16_16_t)mag;
+}
+
+// (a * b) >> 16 senza segno; *ovf = 1 se non sta in 32 bit
+static inline u32 fix_umul_q16(u32 a, u32 b, int *ovf)
+{
+#if FIX_HW_MUL == 2
+    u64 p = (u64)a * b;     // mul + mulhu
+    *ovf = (p >> 48) != 0;
+    return (u32)(p >> 16);
+#else
+    // Quattro prodotti parziali 16x16
+    u16 ah = fix_hi16(a), al = (u16)a;
+    u16 bh = fix_hi16(b), bl = (u16)b;
+    u32 hh = fix_umul16(ah, bh);
+    u32 hl = fix_umul16(ah, bl);
+    u32 lh = fix_umul16(al, bh);
+    u32 ll = fix_hi16(fix_umul16(al, bl));
+    u32 r;
+
+    *ovf = (hh > 0xFFFF);
+    r = fix_shl16((u16)hh);
+    r += hl;    if (r < hl) *ovf = 1;   // Riporto oltre i 32 bit
+    r += lh;    if (r < lh) *ovf = 1;
+    r += ll;    if (r < ll) *ovf = 1;
+    return r;
+#endif
+}
+
+static inline q16_16_t q16_mul(q16_16_t a, q16_16_t b)
+{
+    u32 ua = (a < 0) ? 0U - (u32)a : (u32)a;
+    u32 ub = (b < 0) ? 0U - (u32)b : (u32)b;
+    int ovf;
+    u32 m = fix_umul_q16(ua, ub, &ovf);
+    return q16_sign_sat(m, (a ^ b) < 0, ovf);
+}
+
+// (a << 16) / b senza segno; *ovf = 1 se il quoziente non sta in 32 bit
+static inline u32 fix_udiv_q16(u32 a, u32 b, int *ovf)
+{
+    u32 q, r;
+    int i;
+
+    *ovf = 0;
+    if (b == 0) { *ovf = 1; return 0xFFFFFFFF; }
+
+#if FIX_HW_DIV
+    // Un dividendo a 16 bit sta tutto in 32 bit dopo lo shift: una sola idiv
+    if (a <= 0xFFFF)
+        return fix_shl16((u16)a) / b;
+#endif
+
+    q = fix_udivmod32(a, b, &r);        // Parte intera e resto
+    if (q > 0xFFFF) { *ovf = 1; return 0xFFFFFFFF; }
+
+    // 16 bit di parte frazionaria, uno alla volta
+    for (i = 0; i < 16; i++) {
+        u32 carry = r & 0x80000000;
+        r <<= 1;
+        q <<= 1;
+        if (carry || r >= b) { r -= b; q |= 1; }
+    }
+    return q;
+}
+
+static inline q16_16_t q16_div(q16_16_t a, q16_16_t b)
+{
+    u32 ua = (a < 0) ? 0U - (u32)a : (u32)a;
+    u32 ub = (b < 0) ? 0U - (u32)b : (u32)b;
+    int ovf;
+    u32 m = fix_udiv_q16(ua, ub, &ovf);
+    return q16_sign_sat(m, (a ^ b) < 0, ovf);
+}
+
+// 1 / x
+static inline q16_16_t q16_recip(q16_16_t x)
+{
+#if FIX_HW_DIV && FIX_HW_MUL
+    // 2^32 / x con una idiv: (2^32 - 1) / x, più uno quando il resto è
+    // x - 1 (allora 2^32 è un multiplo esatto di x)
+    u32 ux = (x < 0) ? 0U - (u32)x : (u32)x;
+    u32 m, r;
+
+    if (ux <= 1)
+        return q16_sign_sat(0xFFFFFFFFU, x < 0, 1);
+    m = fix_udivmod32(0xFFFFFFFFU, ux, &r);
+    if (r == ux - 1)
+        m++;
+    return q16_sign_sat(m, x < 0, 0);
+#else
+    return q16_div(FIX_Q16_ONE, x);
+#endif
+}
+
+#if FIX_HW_FPU
+// Solo con la FPU: senza, ogni conversione sarebbe una chiamata soft-float
+static inline q16_16_t q16_from_float(float f) { return (q16_16_t)(f * 65536.0f); }
+static inline float    q16_to_float(q16_16_t x) { return (float)x * (1.0f / 65536.0f); }
+#endif
+
+// --- 8 BIT (colori, duty, velocità) ---
+// v * k con k in Q8.8 non negativo, arrotondato e saturato a 255
+static inline u8 fix_scale8(u8 v, q8_8_t k)
+{
+    u32 p;
+    if (k <= 0) return 0;
+    p = (fix_umul16(v, (u16)k) + 0x80) >> 8;
+    return (p > 255) ? 255 : (u8)p;
+}
+
+// Interpolazione lineare da a (t = 0) a b (t = 256)
+static inline u8 fix_lerp8(u8 a, u8 b, u16 t)
+{
+    if (t >= 256) return b;
+    if (b >= a) return (u8)(a + (fix_umul16((u16)(b - a), t) >> 8));
+    return (u8)(a - (fix_umul16((u16)(a - b), t) >> 8));
+}
+
+// --- FUNZIONI A TABELLA (fixmath.c) ---
+extern const s16 fix_sin_table[65];     // Quarto d'onda, Q1.15
+extern const u8  fix_gamma_table[256];  // Gamma 2.2 per i LED
+
+// Seno di un angolo (giro = 65536) in Q1.15, interpolato sulla tabella
+static inline s16 fix_sin(u16 angle)
+{
+    u16 quarter = angle & 0x3FFF;
+    u8 idx, frac;
+    s16 y0, y1, y;
+
+    if (angle & 0x4000) quarter = 0x4000 - quarter;     // Secondo e quarto quadrante: specchio
+    idx = (u8)(quarter >> 8);                           // 64 intervalli per quarto
+    frac = (u8)quarter;
+    y0 = fix_sin_table[idx];
+    y1 = fix_sin_table[idx < 64 ? idx + 1 : 64];
+    y = (s16)(y0 + (s16)(fix_umul16((u16)(y1 - y0), frac) >> 8));
+    return (angle & 0x8000) ? (s16)-y : y;
+}
+
+static inline s16 fix_cos(u16 angle)
+{
+    return fix_sin((u16)(angle + 0x4000));
+}
+
+// Luminosità percepita -> duty del PWM
+static inline u8 fix_gamma8(u8 v)
+{
+    return fix_gamma_table[v];
+}
+
+// Prototipi
+int fixmath_bench(void);
+
+#endif
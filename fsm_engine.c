@@ -0,0 +1,44 @@
+#include "fsm_engine.h"
+
+// Imposta lo stato iniziale ed esegue la sua azione di ingresso
+void fsm_init(fsm_t *fsm, const fsm_def_t *def, u8 initial, void *ctx)
+{
+    fsm->def = def;
+    fsm->state = initial;
+    fsm->ctx = ctx;
+
+    if (def->on_entry && def->on_entry[initial])
+        def->on_entry[initial](ctx);
+}
+
+// Consegna un evento alla macchina.
+// Restituisce 1 se l'evento ha prodotto una transizione, 0 se ignorato.
+int fsm_dispatch(fsm_t *fsm, u8 event)
+{
+    const fsm_def_t *def = fsm->def;
+    const fsm_transition_t *t;
+
+    if (event >= def->n_events)
+        return 0;
+
+    t = &def->table[fsm->state * def->n_events + event];
+    if (t->next == 0)
+        return 0; // Evento non previsto in questo stato
+
+    if (t->next == FSM_STAY) {
+        if (t->action) t->action(fsm->ctx);
+        return 1;
+    }
+
+    // Transizione esterna: uscita -> azione -> ingresso
+    if (def->on_exit && def->on_exit[fsm->state])
+        def->on_exit[fsm->state](fsm->ctx);
+    if (t->action)
+        t->action(fsm->ctx);
+
+    fsm->state = t->next - 1;
+
+    if (def->on_entry && def->on_entry[fsm->state])
+        def->on_entry[fsm->state](fsm->ctx);
+    return 1;
+}
@@ -0,0 +1,53 @@
+#ifndef FSM_ENGINE_H
+#define FSM_ENGINE_H
+
+#include "xil_types.h"
+
+// --- MOTORE FSM A TABELLA ---
+// La macchina è descritta da una tabella costante stato x evento, costruita
+// a compile-time con gli inizializzatori designati del C99. Il dispatch di
+// un evento è una sola lettura indicizzata: niente switch da rivalutare.
+// La macchina gira solo quando arriva un evento (fronte pulsante, tick di
+// lampeggio, comando), non a ogni giro del loop.
+
+typedef void (*fsm_action_t)(void *ctx);
+
+typedef struct {
+    u8 next;             // 0 = evento ignorato, FSM_STAY = resta, altrimenti stato + 1
+    fsm_action_t action; // Azione della transizione (può essere NULL)
+} fsm_transition_t;
+
+typedef struct {
+    const fsm_transition_t *table;  // n_states * n_events voci, per righe di stato
+    const fsm_action_t *on_entry;   // Azione di ingresso per stato (o NULL)
+    const fsm_action_t *on_exit;    // Azione di uscita per stato (o NULL)
+    u8 n_states;
+    u8 n_events;
+} fsm_def_t;
+
+typedef struct {
+    const fsm_def_t *def;
+    u8 state;
+    void *ctx;           // Passato alle azioni
+} fsm_t;
+
+#define FSM_STAY 0xFF
+
+// Voci della tabella. Le voci non scritte valgono zero = evento ignorato.
+//   [STATO][EVENTO] = FSM_GOTO(PROSSIMO, azione)  -> uscita, azione, ingresso
+//   [STATO][EVENTO] = FSM_DO(azione)              -> solo azione, stato invariato
+#define FSM_GOTO(next_state, act)   { (u8)((next_state) + 1), (act) }
+#define FSM_DO(act)                 { FSM_STAY, (act) }
+
+// Definizione completa a partire da una tabella [N_STATI][N_EVENTI]
+#define FSM_DEF(tbl, entry, exit_) \
+    { &(tbl)[0][0], (entry), (exit_), \
+      (u8)(sizeof(tbl) / sizeof((tbl)[0])), (u8)(sizeof((tbl)[0]) / sizeof((tbl)[0][0])) }
+
+// Prototipi
+void fsm_init(fsm_t *fsm, const fsm_def_t *def, u8 initial, void *ctx);
+int  fsm_dispatch(fsm_t *fsm, u8 event);
+
+static inline u8 fsm_state(const fsm_t *fsm) { return fsm->state; }
+
+#endif
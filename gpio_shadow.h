@@ -0,0 +1,87 @@
+#ifndef GPIO_SHADOW_H
+#define GPIO_SHADOW_H
+
+#include "xil_types.h"
+#include "mb_interface.h"
+
+// --- REGISTRI OMBRA (shadow) ---
+// Una copia in RAM del valore scritto su un registro di uscita. Le
+// operazioni set/clear/toggle lavorano sulla copia e fanno UNA sola
+// scrittura sul bus AXI: nessuna lettura del registro (read-modify-write).
+// Il registro deve essere scritto solo attraverso la sua ombra.
+//
+// Le operazioni sono atomiche rispetto agli interrupt: salvano il MSR,
+// disabilitano gli interrupt e lo ripristinano, quindi si possono usare
+// sia dal main sia dalla ISR.
+//
+// La prova al banco tools/gpio_shadow_sim.sh conta letture e scritture sul
+// bus, con e senza ombra, ridefinendo GPIO_SH_BUS_WRITE.
+
+typedef struct {
+    volatile u32 *reg;  // Registro fisico (es. dati GPIO)
+    u32 value;          // Ultimo valore scritto
+} gpio_shadow_t;
+
+#define GPIO_SHADOW_INIT(addr)  { (volatile u32 *)(addr), 0 }
+
+// Unico accesso al registro fisico
+#ifndef GPIO_SH_BUS_WRITE
+#define GPIO_SH_BUS_WRITE(sh, v)    (*(sh)->reg = (v))
+#endif
+
+// Sezione critica che rispetta lo stato precedente degli interrupt
+static inline u32 gpio_sh_lock(void)
+{
+    u32 msr = mfmsr();
+    microblaze_disable_interrupts();
+    return msr;
+}
+
+static inline void gpio_sh_unlock(u32 msr)
+{
+    mtmsr(msr);
+}
+
+// Scrive tutto il registro (una scrittura)
+static inline void gpio_sh_write(gpio_shadow_t *sh, u32 value)
+{
+    u32 msr = gpio_sh_lock();
+    sh->value = value;
+    GPIO_SH_BUS_WRITE(sh, value);
+    gpio_sh_unlock(msr);
+}
+
+// Scrive solo i bit in mask (una scrittura)
+static inline void gpio_sh_write_masked(gpio_shadow_t *sh, u32 mask, u32 value)
+{
+    u32 msr = gpio_sh_lock();
+    sh->value = (sh->value & ~mask) | (value & mask);
+    GPIO_SH_BUS_WRITE(sh, sh->value);
+    gpio_sh_unlock(msr);
+}
+
+static inline void gpio_sh_set(gpio_shadow_t *sh, u32 mask)
+{
+    gpio_sh_write_masked(sh, mask, mask);
+}
+
+static inline void gpio_sh_clear(gpio_shadow_t *sh, u32 mask)
+{
+    gpio_sh_write_masked(sh, mask, 0);
+}
+
+static inline void gpio_sh_toggle(gpio_shadow_t *sh, u32 mask)
+{
+    u32 msr = gpio_sh_lock();
+    sh->value ^= mask;
+    GPIO_SH_BUS_WRITE(sh, sh->value);
+    gpio_sh_unlock(msr);
+}
+
+// Valore corrente senza accedere al bus
+static inline u32 gpio_sh_read(const gpio_shadow_t *sh)
+{
+    return sh->value;
+}
+
+#endif
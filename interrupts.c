@@ -1,40 +1,97 @@
 #include <stdio.h>
-#include "platform.h"
 #include "xil_printf.h"
 #include "xio.h"
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xtmrctr_l.h"
+#include "timebase.h"
+#include "dpc.h"
+#include "gpio_shadow.h"
+#include "isr_prof.h"
+#include "isr_budget.h"
+#include "irq_guard.h"
+#include "app_core.h"
+#include "trace.h"
 
 // ASSEGNAZIONI REGISTRI INTERRUPT INTERNO
-volatile int * gpio_0_data = (volatile int*) 0x40000000; // Output (es. LED Tasto 1, 0x1)
-volatile int * IER = (volatile int*) 0x41200008; //  Interrupt Enable Register
-volatile int * MER = (volatile int*) 0x4120001C; // Master Enable Register
-volatile int * IISR = (volatile int*) 0x41200000; // Interrupt Status Register (usato per snapshot)
-volatile int * IIAR = (volatile int*) 0x4120000C; // Interrupt Acknowledge Register
+static gpio_shadow_t gpio_0 = GPIO_SHADOW_INIT(0x40000000); // Output (es. LED Tasto 1, 0x1), via copia ombra
+// IER, MER e IISR (snapshot) sono del nucleo: app_core.h
 
 // Registri GPIO Interrupt del tasto esistente (base 0x40060000)
-volatile int * GGIER_1 = (volatile int*) 0x4006011C;
-volatile int * GIER_1_IPIER = (volatile int*) 0x40060128; // Usato come IPIER
-volatile int * GISR_1_IPISR = (volatile int*) 0x40060120; // Usato come IPISR
-volatile int * GPIO1_TRI_REG = (volatile int*) (0x40060004);
+static volatile int * GGIER_1 = (volatile int*) 0x4006011C;
+static volatile int * GIER_1_IPIER = (volatile int*) 0x40060128; // Usato come IPIER
+static volatile int * GISR_1_IPISR = (volatile int*) 0x40060120; // Usato come IPISR
+static volatile int * GPIO1_TRI_REG = (volatile int*) (0x40060004);
+static volatile int * GPIO1_DATA_REG = (volatile int*) (0x40060000); // Livello del tasto
 
 // NUOVE ASSEGNAZIONI REGISTRI (TASTO ESTERNO - base 0x40050000)
-volatile int * GGIER_2 = (volatile int*) 0x4005011C; // GIER per GPIO 2
-volatile int * IPIER_2 = (volatile int*) 0x40050128; // IPIER per GPIO 2
-volatile int * IPISR_2 = (volatile int*) 0x40050120; // IPISR per GPIO 2
-volatile int * GPIO2_TRI_REG = (volatile int*) (0x40050004); // GPIO TRI Register offset 0x4
-
-
-
-
-void myISR(void) __attribute__((interrupt_handler));
-
-
-
-
-int main(void)
+static volatile int * GGIER_2 = (volatile int*) 0x4005011C; // GIER per GPIO 2
+static volatile int * IPIER_2 = (volatile int*) 0x40050128; // IPIER per GPIO 2
+static volatile int * IPISR_2 = (volatile int*) 0x40050120; // IPISR per GPIO 2
+static volatile int * GPIO2_TRI_REG = (volatile int*) (0x40050004); // GPIO TRI Register offset 0x4
+static volatile int * GPIO2_DATA_REG = (volatile int*) (0x40050000); // Livello del tasto
+
+// --- PROTEZIONE DAI RIMBALZI ---
+// In modalità DEBOUNCE ogni tasto viene mascherato al primo fronte e
+// riarmato dopo BUTTON_QUIET_MS senza fronti, solo a tasto rilasciato: il
+// fronte di rilascio non arriva mai come interrupt (irq_guard.h), quindi
+// un interrupt e un evento per pressione.
+// In modalità RATE passano al massimo BUTTON_RATE_MAX interrupt ogni
+// BUTTON_QUIET_MS. Il riarmo avviene nel tick del timer (GUARD_TICK_CYCLES).
+#define BUTTON_GUARD_MODE   IRQ_GUARD_DEBOUNCE
+#define BUTTON_QUIET_MS     20
+#define BUTTON_RATE_MAX     4
+#define BUTTON_PIN          0x1     // Bit del tasto nei dati del canale 1
+#define BUTTON_RELEASED     0x0     // Livello a riposo (tasti attivi alti)
+
+#ifndef SDT
+#define TMRCTR_BASEADDR     XPAR_TMRCTR_0_BASEADDR
+#else
+#define TMRCTR_BASEADDR     XPAR_XTMRCTR_0_BASEADDR
+#endif
+#define TIMER_COUNTER_0     0
+#define GUARD_TICK_CYCLES   100000  // 1 ms a 100 MHz
+
+static irq_guard_t guard_1; // Tasto esistente
+static irq_guard_t guard_2; // Tasto esterno
+
+
+
+
+// Misura dei cicli della ISR (attiva solo con ISR_PROFILE)
+static isr_prof_t prof_isr = ISR_PROF_INIT;
+
+static int ButtonsInit(void);
+static void ButtonsStep(void);
+static void ButtonsISR(u32 p);
+static void ButtonsStop(void);
+static void ButtonWork(u32 button);
+static int SetupGuardTimer(void);
+
+// Modulo del nucleo (app_core.h): il lavoro differito lo esegue il nucleo
+const app_module_t app_buttons = { "pulsanti", ButtonsInit, ButtonsStep, ButtonsISR, NULL, ButtonsStop };
+
+#ifndef APP_SINGLE_IMAGE
+APP_STANDALONE_MAIN(app_buttons)
+#endif
+
+
+static int ButtonsInit(void)
 {
+    // 0) Base dei tempi, INTC e CPU: già pronti nel nucleo
+
     // 1) Set inputs (TRI=1s)
     *GPIO1_TRI_REG = 0xFFFFFFFF; // Tasto esistente
     *GPIO2_TRI_REG = 0xFFFFFFFF; // Tasto esterno
+    gpio_sh_write(&gpio_0, 0x0); // Allinea la copia ombra dei LED
+
+    // Protezione dai rimbalzi per entrambi i tasti
+    irq_guard_init(&guard_1, GIER_1_IPIER, GISR_1_IPISR, 0x1,
+                   GPIO1_DATA_REG, BUTTON_PIN, BUTTON_RELEASED, BUTTON_GUARD_MODE,
+                   (u32)TB_MS_TO_TICKS(BUTTON_QUIET_MS), BUTTON_RATE_MAX);
+    irq_guard_init(&guard_2, IPIER_2, IPISR_2, 0x1,
+                   GPIO2_DATA_REG, BUTTON_PIN, BUTTON_RELEASED, BUTTON_GUARD_MODE,
+                   (u32)TB_MS_TO_TICKS(BUTTON_QUIET_MS), BUTTON_RATE_MAX);
 
     // 2) Enable device interrupts
     // Tasto esistente (GPIO 1)
@@ -46,32 +103,76 @@ int main(void)
     *IPIER_2 = 0x1;        // Abilita IPIER, Canale 1 (bit 0)
 
     // 3) Enable INTC lines 
-    // Abilita entrambi gli interrupt: IRQ0 (esistente) e IRQ1 (nuovo tasto)
-    *IER = XPAR_BUTTON_IP2INTC_IRPT_MASK | XPAR_GPIO_IP2INTC_IRPT_MASK;
+    // Abilita entrambi gli interrupt: IRQ0 (esistente) e IRQ1 (nuovo tasto),
+    // più il timer che riarma i tasti mascherati
+    SetupGuardTimer();
+    app_core_irq_enable(XPAR_BUTTON_IP2INTC_IRPT_MASK | XPAR_GPIO_IP2INTC_IRPT_MASK |
+                        XPAR_AXI_TIMER_0_INTERRUPT_MASK);
 
-    // Abilita INTC Master Enable e Hardware Interrupt Enable
-    *MER = 0x3; // 0b11 
+    return XST_SUCCESS;
+}
 
-    microblaze_enable_interrupts(); // Abilita gli interrupt globali del MicroBlaze
+// Un giro del loop: le azioni sui LED lasciate dalla ISR le esegue il nucleo (dpc_run)
+static void ButtonsStep(void)
+{
+    ISR_PROF_CHECK("interrupts myISR", prof_isr, ISR_BUDGET_BUTTONS);
+}
 
-    while (1) {
-        // Logica di attesa in loop infinito
-    }
+// Arresto: tasti e timer di riarmo fermi, LED spenti
+static void ButtonsStop(void)
+{
+    *GGIER_1 = 0x0;
+    *GIER_1_IPIER = 0x0;
+    *GGIER_2 = 0x0;
+    *IPIER_2 = 0x0;
+    if (*GISR_1_IPISR & 0x1) *GISR_1_IPISR = 0x1; // IPISR toggle-on-write: solo se a 1
+    if (*IPISR_2 & 0x1) *IPISR_2 = 0x1;
+    app_core_timer_stop(TMRCTR_BASEADDR, TIMER_COUNTER_0);
+    gpio_sh_write(&gpio_0, 0x0);
+}
+
+// Azione del pulsante, eseguita fuori dalla ISR con interrupt abilitati.
+// Stampa anche quanti interrupt e rimbalzi ha prodotto finora il tasto.
+static void ButtonWork(u32 button)
+{
+    irq_guard_t *g = (button == 1) ? &guard_1 : &guard_2;
+
+    gpio_sh_set(&gpio_0, 0x1); // Una sola scrittura, nessuna lettura sul bus
+
+    xil_printf("Tasto %d: pressioni %d, interrupt %d, rimbalzi soppressi %d, rilasci %d, limitati %d\r\n",
+               (int)button, (int)g->events, (int)g->irqs, (int)g->suppressed,
+               (int)g->releases, (int)g->throttled);
+}
+
+// Timer periodico (1 ms) che riarma i tasti dopo la finestra di silenzio
+static int SetupGuardTimer(void)
+{
+    XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_COUNTER_0, 0);
+    XTmrCtr_SetLoadReg(TMRCTR_BASEADDR, TIMER_COUNTER_0, GUARD_TICK_CYCLES);
+    XTmrCtr_LoadTimerCounterReg(TMRCTR_BASEADDR, TIMER_COUNTER_0);
+    XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_COUNTER_0,
+        XTC_CSR_AUTO_RELOAD_MASK | XTC_CSR_ENABLE_INT_MASK | XTC_CSR_DOWN_COUNT_MASK);
+    XTmrCtr_Enable(TMRCTR_BASEADDR, TIMER_COUNTER_0);
+    return XST_SUCCESS;
 }
 
 
-void myISR(void)
+// p = snapshot dello stato INTC (IRQ attivi), letto dalla myISR del nucleo
+static void ButtonsISR(u32 p)
 {
-    unsigned p = *IISR; // Snapshot dello stato INTC (IRQ attivi)
+    ISR_PROF_BEGIN(t_isr);
 
     // 1. GESTIONE INTERRUPT TASTO ESISTENTE (IRQ0)
     if (p & XPAR_BUTTON_IP2INTC_IRPT_MASK) {
 
-        // Azione: Toggle del bit 0 (LED 1)
-        *gpio_0_data |= 0x1;
+        // Clear IPISR del dispositivo (TOW) e maschera il tasto fino al silenzio.
+        // Azione: Toggle del bit 0 (LED 1), differita fuori dalla ISR
+        if (irq_guard_on_irq(&guard_1)) {
+            trace_log_isr(TR_BUTTON, 1, (u16)guard_1.events);
+            dpc_post(ButtonWork, 1);
+        }
 
-        // Acknowledge e Clear
-        *GISR_1_IPISR = 0x1; // Clear IPISR del dispositivo (TOW)
+        // Acknowledge INTC
         *IIAR = XPAR_BUTTON_IP2INTC_IRPT_MASK; // Acknowledge INTC (IRQ0)
 
 
@@ -80,14 +181,30 @@ void myISR(void)
     // 2. GESTIONE INTERRUPT NUOVO TASTO ESTERNO (IRQ1)
     if (p & XPAR_GPIO_IP2INTC_IRPT_MASK) {
 
-        // Azione: Toggle del bit 1 (LED 2)
-        *gpio_0_data |= 0x1;
+        // Clear IPISR del nuovo GPIO (TOW) e maschera il tasto fino al silenzio.
+        // Azione: Toggle del bit 1 (LED 2), differita fuori dalla ISR
+        if (irq_guard_on_irq(&guard_2)) {
+            trace_log_isr(TR_BUTTON, 2, (u16)guard_2.events);
+            dpc_post(ButtonWork, 2);
+        }
 
-        // Acknowledge e Clear
-        *IPISR_2 = 0x1; // Clear IPISR del nuovo GPIO (TOW)
+        // Acknowledge INTC
         *IIAR = XPAR_GPIO_IP2INTC_IRPT_MASK; // Acknowledge INTC (IRQ1)
 
 
     }
+
+    // 3. TICK DEL TIMER: conta i rimbalzi e riarma i tasti in silenzio
+    if (p & XPAR_AXI_TIMER_0_INTERRUPT_MASK) {
+        u32 csr = XTmrCtr_GetControlStatusReg(TMRCTR_BASEADDR, TIMER_COUNTER_0);
+        XTmrCtr_SetControlStatusReg(TMRCTR_BASEADDR, TIMER_COUNTER_0, csr | XTC_CSR_INT_OCCURED_MASK);
+
+        irq_guard_poll(&guard_1);
+        irq_guard_poll(&guard_2);
+
+        *IIAR = XPAR_AXI_TIMER_0_INTERRUPT_MASK;
+    }
+
+    ISR_PROF_END(prof_isr, t_isr);
 }
 
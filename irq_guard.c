@@ -0,0 +1,106 @@
+#include "irq_guard.h"
+#include "timebase.h"
+
+void irq_guard_init(irq_guard_t *g, volatile int *ipier, volatile int *ipisr, u32 ch_mask,
+                    volatile int *data, u32 pin_mask, u32 released,
+                    irq_guard_mode_t mode, u32 window, u16 max_per_window)
+{
+    g->ipier = ipier;
+    g->ipisr = ipisr;
+    g->data = data;
+    g->ch_mask = ch_mask;
+    g->pin_mask = pin_mask;
+    g->released = released & pin_mask;
+    g->window = window;
+    g->max_per_window = max_per_window ? max_per_window : 1;
+    g->mode = mode;
+
+    g->masked = 0;
+    g->in_window = 0;
+    g->window_start = timebase_now32();
+    g->rearm_at = 0;
+
+    g->irqs = 0;
+    g->events = 0;
+    g->suppressed = 0;
+    g->releases = 0;
+    g->throttled = 0;
+    g->last_event = 0;
+}
+
+static inline int guard_pressed(const irq_guard_t *g)
+{
+    return ((u32)*g->data & g->pin_mask) != g->released;
+}
+
+static inline void guard_mask(irq_guard_t *g, u32 rearm_at)
+{
+    *g->ipier = 0;  // Un solo canale per GPIO: IPIER a zero maschera la sorgente
+    g->masked = 1;
+    g->rearm_at = rearm_at;
+}
+
+// Chiamata dalla ISR quando la sorgente ha generato un interrupt.
+// Pulisce l'IPISR (il bit è sicuramente a 1, quindi la scrittura lo azzera).
+int irq_guard_on_irq(irq_guard_t *g)
+{
+    u32 now = timebase_now32();
+
+    g->irqs++;
+    *g->ipisr = g->ch_mask;
+
+    if (g->mode == IRQ_GUARD_DEBOUNCE) {
+        // Primo fronte: sorgente muta fino al silenzio a tasto rilasciato
+        guard_mask(g, now + g->window);
+        g->events++;
+        g->last_event = now;
+        return 1;
+    }
+
+    // IRQ_GUARD_RATE: conteggio per finestra fissa
+    if (now - g->window_start >= g->window) {
+        g->window_start = now;
+        g->in_window = 0;
+    }
+    if (++g->in_window > g->max_per_window) {
+        guard_mask(g, g->window_start + g->window);
+        g->throttled++;
+        return 0;
+    }
+    if (!guard_pressed(g)) {
+        g->releases++;
+        return 0;
+    }
+    g->events++;
+    g->last_event = now;
+    return 1;
+}
+
+// Chiamata dal tick periodico (con gli interrupt della CPU già disabilitati, dalla ISR)
+void irq_guard_poll(irq_guard_t *g)
+{
+    u32 now;
+
+    if (!g->masked)
+        return;
+
+    now = timebase_now32();
+
+    // L'IPISR è toggle-on-write: si scrive solo se il bit è davvero a 1
+    if (*g->ipisr & g->ch_mask) {
+        *g->ipisr = g->ch_mask;
+        g->suppressed++;
+        if (g->mode == IRQ_GUARD_DEBOUNCE)
+            g->rearm_at = now + g->window; // Rimbalza ancora: la finestra riparte
+    }
+
+    if ((s32)(now - g->rearm_at) >= 0) {
+        // Ancora premuto: si aspetta il rilascio, sempre a sorgente muta
+        if (g->mode == IRQ_GUARD_DEBOUNCE && guard_pressed(g)) {
+            g->rearm_at = now + g->window;
+            return;
+        }
+        g->masked = 0;
+        *g->ipier = g->ch_mask;
+    }
+}
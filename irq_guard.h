@@ -0,0 +1,65 @@
+#ifndef IRQ_GUARD_H
+#define IRQ_GUARD_H
+
+#include "xil_types.h"
+
+// --- PROTEZIONE DALLE TEMPESTE DI INTERRUPT (pulsanti GPIO) ---
+// Un contatto meccanico che rimbalza genera decine di fronti per pressione,
+// e ogni fronte costa un interrupt. Due modalità per sorgente:
+//
+//  IRQ_GUARD_DEBOUNCE: al primo fronte la sorgente viene mascherata (IPIER)
+//      e l'evento registrato con il suo istante. Un tick periodico la
+//      riarma solo dopo 'window' tick senza fronti e a tasto rilasciato.
+//  IRQ_GUARD_RATE: al massimo 'max_per_window' interrupt per finestra; oltre
+//      la sorgente resta mascherata fino alla fine della finestra.
+//
+// Mentre la sorgente è mascherata l'IPISR del GPIO continua a registrare i
+// fronti: il tick li conta (rimbalzi soppressi) senza prendere interrupt.
+//
+// Il GPIO AXI interrompe su entrambi i fronti, e una pressione dura più
+// della finestra. Per questo alla scadenza si legge il livello del pin
+// ('data' & 'pin_mask'): se il tasto è ancora premuto la sorgente resta
+// mascherata e la scadenza si sposta di una finestra; il rilascio e i
+// suoi rimbalzi finiscono tra i soppressi. Così un interrupt e un evento
+// per pressione. In IRQ_GUARD_RATE un interrupt è un evento solo se il
+// pin, letto nella ISR, è premuto.
+//
+// Prova al banco senza scheda: tools/irq_guard_sim.sh (rimbalzi simulati).
+
+typedef enum { IRQ_GUARD_DEBOUNCE, IRQ_GUARD_RATE } irq_guard_mode_t;
+
+typedef struct {
+    // Configurazione
+    volatile int *ipier;    // IP Interrupt Enable del GPIO
+    volatile int *ipisr;    // IP Interrupt Status del GPIO (toggle-on-write)
+    volatile int *data;     // Dati del canale: livello del pin
+    u32 ch_mask;            // Canale della sorgente (bit 0 = canale 1)
+    u32 pin_mask;           // Bit del pin in 'data'
+    u32 released;           // data & pin_mask a tasto rilasciato
+    u32 window;             // Finestra in tick della base dei tempi
+    u16 max_per_window;     // Solo IRQ_GUARD_RATE
+    u8  mode;
+
+    // Stato
+    u8  masked;
+    u16 in_window;
+    u32 window_start;
+    u32 rearm_at;           // Istante di riarmo mentre è mascherata
+
+    // Contatori
+    u32 irqs;               // Interrupt presi
+    u32 events;             // Eventi accettati (pressioni)
+    u32 suppressed;         // Fronti visti a sorgente mascherata
+    u32 releases;           // Fronti di rilascio scartati (IRQ_GUARD_RATE)
+    u32 throttled;          // Volte in cui il limitatore ha mascherato
+    u32 last_event;         // Istante (timebase_now32) dell'ultimo evento
+} irq_guard_t;
+
+// Prototipi
+void irq_guard_init(irq_guard_t *g, volatile int *ipier, volatile int *ipisr, u32 ch_mask,
+                    volatile int *data, u32 pin_mask, u32 released,
+                    irq_guard_mode_t mode, u32 window, u16 max_per_window);
+int  irq_guard_on_irq(irq_guard_t *g);  // Dalla ISR del GPIO: 1 = evento accettato
+void irq_guard_poll(irq_guard_t *g);    // Dal tick periodico: conta i rimbalzi e riarma
+
+#endif
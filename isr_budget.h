@@ -0,0 +1,60 @@
+#ifndef ISR_BUDGET_H
+#define ISR_BUDGET_H
+
+// --- BUDGET DI CICLI ---
+// Caso peggiore ammesso per invocazione, in cicli di clock a 100 MHz,
+// misurato con isr_prof (ISR_PROFILE). Una misura oltre il budget viene
+// stampata come FAIL: è una regressione da capire prima di andare avanti.
+//
+// 0 = nessun budget ancora: isr_prof stampa la misura senza giudizio.
+// Un budget si fissa solo da misure:
+//   - sulla scheda, comando 'p' dei moduli (cicli veri, caso peggiore
+//     visto durante la prova)
+//   - con il banco su QEMU, tools/bench/bench.sh: istruzioni e accessi
+//     AXI per ogni ramo delle ISR, confrontati con tools/bench/baseline.txt
+//     (qui le regressioni si vedono senza scheda, ma non sono cicli)
+// Il valore è il massimo misurato sulla scheda più un margine, con la
+// data e la configurazione della prova nel commento.
+
+#define ISR_BUDGET_PWM          0       // PWM.c       myISR (tick 250 kHz)
+#define ISR_BUDGET_PWM_UART     0       // PWM&uart.c  myISR (tick 250 kHz)
+#define ISR_BUDGET_ROVER        0       // Rover.c     myISR (tick motori e lampeggio insieme)
+#define ISR_BUDGET_ROVER_TICK   0       // Rover.c     solo il tick motori
+#define ISR_BUDGET_FSM          0       // FSM.c       myISR (tick 0.5 s)
+#define ISR_BUDGET_TIMER        0       // timer.c     myISR (tick 1 s)
+#define ISR_BUDGET_BUTTONS      0       // interrupts.c myISR (fronti dei pulsanti e tick di riarmo insieme)
+
+// Quota massima del periodo di tick che una ISR di PWM può occupare:
+// pwm_cfg rifiuta frequenze e risoluzioni che la superano. È un requisito
+// (metà del tempo resta al loop), non una misura.
+#define PWM_LOAD_MAX_PCT        50
+
+// Parti di una ISR
+#define ISR_BUDGET_RAMP         0       // Rover.c     motor_ramp_tick x 2 per tick PWM
+
+// Percorsi caldi del loop principale (le stampe di diagnostica sono escluse)
+#define LOOP_BUDGET_ROVER_CMD   0       // Rover.c     ProcessCommand e comandi a parole
+#define LOOP_BUDGET_RGB_UPDATE  0       // PWM&uart.c  update_leds
+
+// Analisi di un byte della seriale (console.c, comandi esclusi): come
+// PWM_LOAD_MAX_PCT è un requisito, non una misura. A 115200 baud, 8N1,
+// un byte sono 10 bit e ne arriva uno ogni 86,8 us = 8680 cicli a 100 MHz;
+// l'analisi ne può prendere al massimo un quarto, così anche con una riga
+// battuta di fila il resto del giro del loop (step del modulo, ISR) ci sta
+// e la FIFO di ricezione della UART Lite (16 byte) non si riempie.
+// Si verifica sulla scheda con 'p' e, come limite inferiore, sul PC con
+// tools/console_sim.sh.
+#define LOOP_BUDGET_CONSOLE_BYTE 2170
+
+// --- CAMBIO DI MODULO (immagine unica, app_core) ---
+// Dallo stop del modulo attivo alla fine dell'init del nuovo, in microsecondi
+#define APP_SWITCH_BUDGET_US    2000
+
+// --- BUDGET DI MEMORIA ---
+// Massimo uso dello stack misurato a runtime (stack_mon), in percentuale
+// dello stack riservato dal linker script. Il resto è margine per le
+// funzioni nuove (filtri, log). L'ingombro statico (text/data/bss e stack
+// per funzione) è tracciato da tools/mem_report.sh in tools/mem_baseline.txt.
+#define STACK_BUDGET_PCT        75
+
+#endif
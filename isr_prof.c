@@ -0,0 +1,57 @@
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "mb_interface.h"
+#include "isr_prof.h"
+
+// Stampa le statistiche di un punto di misura confrontandole con il budget
+// (0 = nessun budget ancora, solo la misura). Restituisce XST_FAILURE se il
+// caso peggiore supera il budget (regressione).
+int isr_prof_report(const char *name, const isr_prof_t *p, u32 budget)
+{
+    isr_prof_t snap;
+    u32 avg = 0;
+
+    // Copia coerente: la ISR potrebbe aggiornare i campi durante la stampa
+    microblaze_disable_interrupts();
+    snap = *p;
+    microblaze_enable_interrupts();
+
+    if (snap.count == 0) {
+        xil_printf("%s: nessuna misura\r\n", name);
+        return XST_SUCCESS;
+    }
+
+    avg = (u32)(snap.total / snap.count);
+    if (budget == 0) {
+        xil_printf("%s: n=%d cicli min %d media %d max %d (nessun budget)\r\n",
+                   name, (int)snap.count, (int)snap.min, (int)avg, (int)snap.max);
+        return XST_SUCCESS;
+    }
+    xil_printf("%s: n=%d cicli min %d media %d max %d (budget %d) %s\r\n",
+               name, (int)snap.count, (int)snap.min, (int)avg, (int)snap.max,
+               (int)budget, (snap.max > budget) ? "FAIL" : "OK");
+
+    return (snap.max > budget) ? XST_FAILURE : XST_SUCCESS;
+}
+
+// Da chiamare nel loop principale dei programmi senza comandi da seriale:
+// segnala una sola volta il primo superamento del budget (se c'è).
+void isr_prof_check(const char *name, isr_prof_t *p, u32 budget)
+{
+    if (budget != 0 && !p->reported && p->max > budget) {
+        p->reported = 1;
+        isr_prof_report(name, p, budget);
+    }
+}
+
+void isr_prof_reset(isr_prof_t *p)
+{
+    microblaze_disable_interrupts();
+    p->count = 0;
+    p->last = 0;
+    p->min = 0xFFFFFFFF;
+    p->max = 0;
+    p->total = 0;
+    p->reported = 0;
+    microblaze_enable_interrupts();
+}
@@ -0,0 +1,61 @@
+#ifndef ISR_PROF_H
+#define ISR_PROF_H
+
+#include "xil_types.h"
+#include "timebase.h"
+
+// --- PROFILAZIONE DELLE ISR ---
+// Misura i cicli di ogni invocazione di una ISR (o di un percorso caldo del
+// main) con la base dei tempi: il timer gira allo stesso clock della CPU,
+// quindi un tick = un ciclo. Il conteggio parte dalla prima istruzione del
+// corpo e finisce all'ultima: il salvataggio/ripristino dei registri fatto
+// dal compilatore per interrupt_handler e la rtid restano fuori.
+//
+// Si attiva compilando con ISR_PROFILE; senza, le macro spariscono e il
+// codice delle ISR è identico a prima. I limiti ammessi sono in isr_budget.h.
+
+typedef struct {
+    u32 count;          // Invocazioni misurate
+    u32 last;           // Cicli dell'ultima invocazione
+    u32 min;
+    u32 max;
+    u64 total;          // Per la media
+    u8  reported;       // Superamento del budget già segnalato
+} isr_prof_t;
+
+#define ISR_PROF_INIT   { 0, 0, 0xFFFFFFFF, 0, 0, 0 }
+
+static inline void isr_prof_record(isr_prof_t *p, u32 cycles)
+{
+    p->count++;
+    p->last = cycles;
+    p->total += cycles;
+    if (cycles < p->min) p->min = cycles;
+    if (cycles > p->max) p->max = cycles;
+}
+
+// Cicli da usare per dimensionare: il caso peggiore misurato, 0 se non
+// c'è ancora nessuna misura (senza ISR_PROFILE sempre 0)
+static inline u32 isr_prof_measured(const isr_prof_t *p)
+{
+    return p->count ? p->max : 0;
+}
+
+// Ogni misura ha il suo nome per l'istante di partenza (t): le misure si
+// possono annidare, es. il tick motori dentro l'intera ISR del rover.
+#ifdef ISR_PROFILE
+#define ISR_PROF_BEGIN(t)       u32 t = timebase_now32()
+#define ISR_PROF_END(p, t)      isr_prof_record(&(p), timebase_now32() - (t))
+#define ISR_PROF_CHECK(n, p, b) isr_prof_check((n), &(p), (b))
+#else
+#define ISR_PROF_BEGIN(t)       do {} while (0)
+#define ISR_PROF_END(p, t)      do {} while (0)
+#define ISR_PROF_CHECK(n, p, b) do {} while (0)
+#endif
+
+// Prototipi
+int  isr_prof_report(const char *name, const isr_prof_t *p, u32 budget);
+void isr_prof_check(const char *name, isr_prof_t *p, u32 budget);
+void isr_prof_reset(isr_prof_t *p);
+
+#endif
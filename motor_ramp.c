@@ -0,0 +1,16 @@
+#include "motor_ramp.h"
+
+// Ruota ferma, direzione 0, obiettivo zero.
+// rate_max: accelerazione massima (vedi RAMP_RATE_FULL_MS), almeno 1.
+// jerk:     0 per una rampa lineare, altrimenti passo della curva S.
+void motor_ramp_init(motor_ramp_t *m, u16 rate_max, u16 jerk)
+{
+    m->speed = 0;
+    m->dir = 0;
+    m->ramp_steps = 0;
+    m->setpoint = 0;
+    m->acc = 0;
+    m->rate_max = rate_max ? rate_max : 1;
+    m->jerk = (jerk > m->rate_max) ? m->rate_max : jerk;
+    m->rate = m->jerk ? m->jerk : m->rate_max;
+}
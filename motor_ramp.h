@@ -0,0 +1,105 @@
+#ifndef MOTOR_RAMP_H
+#define MOTOR_RAMP_H
+
+#include "xil_types.h"
+
+// --- RAMPA DI VELOCITÀ (limitatore di accelerazione) ---
+// Ogni ruota insegue il suo setpoint un passo di velocità alla volta.
+// L'avanzamento è alla Bresenham: a ogni tick del timer si somma 'rate'
+// a un accumulatore a 16 bit e il riporto (overflow) vale un passo.
+// Nella ISR solo somme, confronti e incrementi: nessuna moltiplicazione
+// né divisione.
+//
+// Un cambio di direzione passa sempre da zero: prima si frena fino a
+// fermarsi, poi si inverte e si riaccelera.
+//
+// Con jerk != 0 la rampa è a S: il rate cresce di 'jerk' a ogni passo
+// fino a rate_max e cala allo stesso modo quando mancano tanti passi
+// quanti ne sono serviti per accelerare.
+
+typedef struct {
+    u8  speed;              // Velocità applicata al PWM (0-255)
+    u8  dir;                // Direzione applicata
+    u8  ramp_steps;         // Passi fatti con il rate in crescita (curva S)
+    volatile u16 setpoint;  // Velocità obiettivo | direzione << 8 (una sola scrittura)
+    u16 acc;                // Accumulatore Bresenham
+    u16 rate;               // Incremento per tick attuale
+    u16 rate_max;           // Incremento per tick massimo (accelerazione)
+    u16 jerk;               // Variazione del rate per passo (0 = rampa lineare)
+} motor_ramp_t;
+
+// Rate per andare da 0 a 255 in 'ms' millisecondi con un tick a 'tick_hz'.
+// Calcolato a compile-time: un passo ogni 65536 / rate tick.
+#define RAMP_RATE_FULL_MS(ms, tick_hz) \
+    ((u16)(((255ULL << 16) * 1000ULL) / ((u64)(ms) * (tick_hz))))
+
+// Prototipi
+void motor_ramp_init(motor_ramp_t *m, u16 rate_max, u16 jerk);
+
+// Nuovo obiettivo dal main: velocità e direzione in un'unica scrittura a 16 bit,
+// così la ISR non vede mai una coppia mescolata.
+static inline void motor_ramp_set(motor_ramp_t *m, u8 speed, u8 dir)
+{
+    m->setpoint = (u16)speed | ((u16)(dir & 0x1) << 8);
+}
+
+// Nuova accelerazione massima, per esempio dopo un cambio di frequenza del
+// tick PWM. Da chiamare a interrupt disabilitati: la ISR legge gli stessi campi.
+static inline void motor_ramp_set_rate(motor_ramp_t *m, u16 rate_max)
+{
+    m->rate_max = rate_max ? rate_max : 1;
+    if (m->rate > m->rate_max) m->rate = m->rate_max;
+}
+
+// Avanzamento di un tick, da chiamare nella ISR del PWM
+static inline void motor_ramp_tick(motor_ramp_t *m)
+{
+    u16 sp = m->setpoint;
+    u8 target = (u8)sp;
+    u8 tdir = (u8)(sp >> 8);
+    u16 old;
+    u8 remaining;
+
+    // Inversione: prima si frena a zero, da fermi si cambia direzione
+    if (tdir != m->dir) {
+        if (m->speed == 0) {
+            m->dir = tdir;
+            m->ramp_steps = 0; // La nuova rampa riparte dall'inizio
+            m->rate = m->jerk ? m->jerk : m->rate_max;
+        } else {
+            target = 0;
+        }
+    }
+
+    // Percorso rapido: già all'obiettivo. La rampa si azzera una volta
+    // sola, all'arrivo; a regime nessuna scrittura.
+    if (m->speed == target) {
+        u16 rest = m->jerk ? m->jerk : m->rate_max;
+        if (m->acc == 0 && m->ramp_steps == 0 && m->rate == rest)
+            return;
+        m->acc = 0;
+        m->ramp_steps = 0;
+        m->rate = rest;
+        return;
+    }
+
+    old = m->acc;
+    m->acc = old + m->rate;
+    if (m->acc >= old) return; // Nessun riporto: nessun passo in questo tick
+
+    if (m->speed < target) { m->speed++; remaining = target - m->speed; }
+    else                   { m->speed--; remaining = m->speed - target; }
+
+    // Curva S: accelerazione che cresce e poi cala in modo simmetrico
+    if (m->jerk) {
+        if (remaining <= m->ramp_steps) {
+            if (m->rate > m->jerk) m->rate -= m->jerk;
+            if (m->ramp_steps) m->ramp_steps--;
+        } else if (m->rate < m->rate_max) {
+            m->rate = (m->rate_max - m->rate > m->jerk) ? m->rate + m->jerk : m->rate_max;
+            m->ramp_steps++;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,238 @@
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "pwm_cfg.h"
+#include "isr_budget.h"
+#include "trace.h"
+#include "boot.h"
+
+// Configurazioni pronte, scelte da seriale con "w<n>". Hanno tutte un
+// tick di almeno 400 cicli come quella di fabbrica, quindi passano anche
+// senza misure; con una misura, solo se il caso peggiore della ISR sta in
+// PWM_LOAD_MAX_PCT del tick (200 cicli con un tick di 400).
+static const struct { u32 freq_hz; u8 bits; } pwm_presets[] = {
+    {   976, 8 },   // 0: di fabbrica, 256 livelli (udibile sui motori)
+    {   100, 8 },   // 1: solo LED, carico minimo
+    {  1953, 7 },   // 2: tick 400 cicli
+    {  3906, 6 },   // 3: tick 400 cicli
+    {  7812, 5 },   // 4: tick 400 cicli
+    { 15625, 4 },   // 5: tick 400 cicli, 16 livelli
+    { 20000, 3 },   // 6: fuori dall'udibile, 8 livelli (tick 625 cicli)
+    { 31250, 3 },   // 7: fuori dall'udibile, 8 livelli (tick 400 cicli)
+};
+#define PWM_N_PRESETS   (sizeof(pwm_presets) / sizeof(pwm_presets[0]))
+
+// Frequenze e risoluzioni della tabella del carico ("W")
+static const u32 pwm_table_freq[] = { 100, 500, 976, 1953, 3906, 7812, 15625, 20000, 31250 };
+#define PWM_TABLE_N_FREQ    (sizeof(pwm_table_freq) / sizeof(pwm_table_freq[0]))
+#define PWM_TABLE_BITS_MIN  3
+
+// Calcola la configurazione e la valida. Le divisioni stanno qui, nel
+// main, mai nella ISR. Restituisce XST_FAILURE se i parametri sono fuori
+// campo o se la ISR misurata supererebbe PWM_LOAD_MAX_PCT del periodo;
+// senza misura, se il tick è più veloce di quello di fabbrica.
+int pwm_cfg_compute(pwm_cfg_t *cfg, u32 freq_hz, u8 bits, u32 isr_cycles)
+{
+    cfg->freq_hz = freq_hz;
+    cfg->bits = bits;
+    cfg->inc = 0;
+    cfg->tick_hz = 0;
+    cfg->period = 0;
+    cfg->load = 0;
+    cfg->isr_cycles = isr_cycles;
+    cfg->load_pct = 100;
+
+    if (bits < PWM_BITS_MIN || bits > PWM_BITS_MAX)
+        return XST_FAILURE;
+    if (freq_hz == 0 || freq_hz > (PWM_CLK_HZ >> bits) / PWM_PERIOD_MIN)
+        return XST_FAILURE;
+
+    cfg->inc = (u8)(256U >> bits);
+    cfg->tick_hz = freq_hz << bits;
+    cfg->period = PWM_CLK_HZ / cfg->tick_hz;
+    cfg->load = cfg->period - 2;
+    if (isr_cycles == 0) {
+        cfg->load_pct = 0;
+        return (cfg->period < PWM_DEFAULT_PERIOD) ? XST_FAILURE : XST_SUCCESS;
+    }
+    cfg->load_pct = (isr_cycles * 100U) / cfg->period;
+
+    return (cfg->load_pct > PWM_LOAD_MAX_PCT) ? XST_FAILURE : XST_SUCCESS;
+}
+
+// Avvio del modulo: riprende l'ultima configurazione scelta (quella di
+// fabbrica la prima volta), la rivalida, programma il timer (Auto-Reload,
+// Interrupt, conto alla rovescia) e lo fa partire. Non fallisce mai: se
+// la configurazione scelta non passa si torna a quella di fabbrica, che
+// parte comunque (è quella di sempre); se la misura dice che nemmeno lei
+// sta nel carico massimo, lo stampa.
+void pwm_rt_init(pwm_rt_t *rt, UINTPTR base, u8 timer, u32 isr_cycles)
+{
+    pwm_cfg_t cfg;
+    u32 freq_hz = rt->cfg.freq_hz ? rt->cfg.freq_hz : PWM_DEFAULT_FREQ_HZ;
+    u8 bits = rt->cfg.freq_hz ? rt->cfg.bits : PWM_DEFAULT_BITS;
+
+    if (pwm_cfg_compute(&cfg, freq_hz, bits, isr_cycles) != XST_SUCCESS &&
+        pwm_cfg_compute(&cfg, PWM_DEFAULT_FREQ_HZ, PWM_DEFAULT_BITS, isr_cycles) != XST_SUCCESS) {
+        xil_printf("PWM: di fabbrica oltre il carico massimo, ");
+        pwm_cfg_print(&cfg);
+    }
+
+    rt->base = base;
+    rt->timer = timer;
+    rt->counter = 0;
+    rt->inc = cfg.inc;
+    rt->pending = PWM_RT_IDLE;
+    rt->cmd = 0;
+    rt->cfg = cfg;
+
+    XTmrCtr_SetControlStatusReg(base, timer, 0);
+    XTmrCtr_SetLoadReg(base, timer, cfg.load);
+    XTmrCtr_LoadTimerCounterReg(base, timer);
+    XTmrCtr_SetControlStatusReg(base, timer,
+        XTC_CSR_AUTO_RELOAD_MASK | XTC_CSR_ENABLE_INT_MASK | XTC_CSR_DOWN_COUNT_MASK);
+    XTmrCtr_Enable(base, timer);
+}
+
+// Cambio a runtime, dal main: la ISR lo applica a fine periodo.
+// XST_FAILURE se il cambio precedente non è ancora stato applicato.
+int pwm_rt_request(pwm_rt_t *rt, const pwm_cfg_t *cfg)
+{
+    if (rt->pending != PWM_RT_IDLE)
+        return XST_FAILURE;
+
+    rt->next_inc = cfg->inc;
+    rt->next_load = cfg->load;
+    rt->cfg = *cfg;
+    // I campi non sono volatile: la barriera tiene le loro scritture
+    // prima della pubblicazione, che la ISR legge
+    __asm__ volatile ("" ::: "memory");
+    rt->pending = PWM_RT_REQUESTED; // Pubblica solo dopo aver scritto i valori
+    return XST_SUCCESS;
+}
+
+void pwm_cfg_print(const pwm_cfg_t *cfg)
+{
+    u32 real_hz = cfg->tick_hz ? (PWM_CLK_HZ / cfg->period) >> cfg->bits : 0;
+
+    xil_printf("PWM: %d Hz (reale %d) %d bit, tick %d Hz, %d cicli, ",
+               (int)cfg->freq_hz, (int)real_hz, (int)cfg->bits, (int)cfg->tick_hz,
+               (int)cfg->period);
+    if (cfg->isr_cycles)
+        xil_printf("carico %d (max %d)\r\n", (int)cfg->load_pct, PWM_LOAD_MAX_PCT);
+    else
+        xil_printf("carico non misurato (tick minimo %d cicli)\r\n", (int)PWM_DEFAULT_PERIOD);
+}
+
+// Tabella del carico CPU (percentuale) per frequenza e risoluzione, dai
+// cicli misurati della ISR; "--" dove la configurazione non è valida.
+// Senza misura non c'è un carico da stampare: "ok" dove il tick non è più
+// veloce di quello di fabbrica. La stessa tabella, da una misura o dal
+// banco su QEMU, la fa tools/pwm_load.py sul PC.
+void pwm_cfg_table(u32 isr_cycles)
+{
+    pwm_cfg_t cfg;
+    u32 i;
+    u8 bits;
+
+    if (isr_cycles)
+        xil_printf("Carico %% della ISR (%d cicli misurati) per frequenza e bit\r\nHz", (int)isr_cycles);
+    else
+        xil_printf("ISR non misurata (ISR_PROFILE): configurazioni ammesse\r\nHz");
+    for (bits = PWM_TABLE_BITS_MIN; bits <= PWM_BITS_MAX; bits++)
+        xil_printf("\t%d", (int)bits);
+    xil_printf("\r\n");
+
+    for (i = 0; i < PWM_TABLE_N_FREQ; i++) {
+        xil_printf("%d", (int)pwm_table_freq[i]);
+        for (bits = PWM_TABLE_BITS_MIN; bits <= PWM_BITS_MAX; bits++) {
+            if (pwm_cfg_compute(&cfg, pwm_table_freq[i], bits, isr_cycles) != XST_SUCCESS)
+                xil_printf("\t--");
+            else if (isr_cycles)
+                xil_printf("\t%d", (int)cfg.load_pct);
+            else
+                xil_printf("\tok");
+        }
+        xil_printf("\r\n");
+    }
+}
+
+// Passa a una frequenza e risoluzione qualsiasi (senza glitch).
+// Restituisce PWM_CMD_CHANGED se il cambio è partito, PWM_CMD_USED se
+// è stato rifiutato (il motivo è già stampato).
+int pwm_cfg_set(pwm_rt_t *rt, u32 freq_hz, u8 bits, u32 isr_cycles)
+{
+    pwm_cfg_t cfg;
+
+    if (pwm_cfg_compute(&cfg, freq_hz, bits, isr_cycles) != XST_SUCCESS) {
+        xil_printf("PWM: rifiutato, ");
+        pwm_cfg_print(&cfg);
+        return PWM_CMD_USED;
+    }
+    if (pwm_rt_request(rt, &cfg) != XST_SUCCESS) {
+        xil_printf("PWM: cambio precedente in corso\r\n");
+        return PWM_CMD_USED;
+    }
+    pwm_cfg_print(&cfg);
+    return PWM_CMD_CHANGED;
+}
+
+// Comandi da seriale comuni ai moduli con PWM:
+//   w<n>  passa al preset n (senza glitch)
+//   W     stampa la configurazione attiva, i preset e la tabella del carico
+// Dopo "w" un byte che non è una cifra (fine riga compresa) annulla il
+// comando e resta del gestore: PWM_CMD_NONE, così "wf" esegue 'f'. Un
+// record di traccia per comando eseguito (TR_KEY, b = preset).
+int pwm_cfg_command(pwm_rt_t *rt, u8 c, u32 isr_cycles)
+{
+    u32 i;
+
+    if (rt->cmd == 'w') {
+        rt->cmd = 0;
+        if (c < '0' || c > '9')
+            return PWM_CMD_NONE;
+        i = (u32)(c - '0');
+        if (i >= PWM_N_PRESETS) {
+            xil_printf("PWM: preset %c inesistente\r\n", c);
+            return PWM_CMD_USED;
+        }
+        trace_log(TR_KEY, 'w', (u16)i);
+        boot_mark(BOOT_PH_CMD);
+        return pwm_cfg_set(rt, pwm_presets[i].freq_hz, pwm_presets[i].bits, isr_cycles);
+    }
+
+    if (c == 'w') {
+        rt->cmd = 'w';
+        return PWM_CMD_USED;
+    }
+
+    if (c == 'W') {
+        trace_log(TR_KEY, 'W', 0);
+        boot_mark(BOOT_PH_CMD);
+        pwm_cfg_print(&rt->cfg);
+        for (i = 0; i < PWM_N_PRESETS; i++)
+            xil_printf("w%d: %d Hz %d bit\r\n", (int)i,
+                       (int)pwm_presets[i].freq_hz, (int)pwm_presets[i].bits);
+        pwm_cfg_table(isr_cycles);
+        return PWM_CMD_USED;
+    }
+
+    return PWM_CMD_NONE;
+}
+
+// Comando a parole "hz [freq [bit]]" (console.h): senza argomenti stampa
+// la configurazione attiva, senza i bit tiene quelli attuali
+int pwm_cfg_console(pwm_rt_t *rt, const s32 *argv, u8 argc, u32 isr_cycles)
+{
+    s32 bits = (argc > 1) ? argv[1] : rt->cfg.bits;
+
+    if (argc == 0) {
+        pwm_cfg_print(&rt->cfg);
+        return PWM_CMD_USED;
+    }
+    if (argv[0] <= 0 || bits < PWM_BITS_MIN || bits > PWM_BITS_MAX) {
+        xil_printf("PWM: %d Hz %d bit fuori campo (bit %d-%d)\r\n",
+                   (int)argv[0], (int)bits, PWM_BITS_MIN, PWM_BITS_MAX);
+        return PWM_CMD_USED;
+    }
+    return pwm_cfg_set(rt, (u32)argv[0], (u8)bits, isr_cycles);
+}
@@ -0,0 +1,109 @@
+#ifndef PWM_CFG_H
+#define PWM_CFG_H
+
+#include "xil_types.h"
+#include "xtmrctr_l.h"
+
+// --- CONFIGURAZIONE DEL PWM SOFTWARE (frequenza / risoluzione) ---
+// Il PWM è generato dalla ISR di un AXI Timer: a ogni tick il contatore
+// di fase a 8 bit avanza di 'inc' e l'uscita è accesa finché è sotto il
+// duty (0-255). Con 'bits' di risoluzione il periodo dura 2^bits tick:
+//
+//   tick_hz = freq_hz << bits          (interrupt al secondo)
+//   period  = PWM_CLK_HZ / tick_hz     (cicli tra due interrupt)
+//   inc     = 256 >> bits              (il contatore a 8 bit gira in 2^bits tick)
+//
+// Frequenza alta e risoluzione alta vogliono entrambe più interrupt: la
+// configurazione è valida solo se la ISR (caso peggiore misurato con
+// isr_prof) occupa al massimo PWM_LOAD_MAX_PCT del periodo. Senza misure
+// (isr_cycles 0, es. senza ISR_PROFILE) il carico non si conosce: si
+// accettano solo tick non più veloci di quello di fabbrica, che è quello
+// con cui i programmi girano da sempre.
+//
+// Il cambio a runtime è senza glitch: il main prepara la nuova
+// configurazione e la ISR la applica a fine periodo. Nell'ultimo tick
+// scrive il nuovo valore di ricarica (vale dalla ricarica successiva),
+// al giro del contatore cambia il passo: nessun periodo misto.
+
+#define PWM_CLK_HZ          100000000U  // Clock dell'AXI Timer
+#define PWM_BITS_MIN        1
+#define PWM_BITS_MAX        8           // Il duty resta sempre un u8 (0-255)
+#define PWM_PERIOD_MIN      20          // Cicli minimi tra due interrupt
+
+// Configurazione di fabbrica: quella di sempre (tick di 400 cicli, cioè
+// load 398, 8 bit, ~976 Hz)
+#define PWM_DEFAULT_FREQ_HZ 976
+#define PWM_DEFAULT_BITS    8
+#define PWM_DEFAULT_PERIOD  (PWM_CLK_HZ / (PWM_DEFAULT_FREQ_HZ << PWM_DEFAULT_BITS))
+
+typedef struct {
+    u32 freq_hz;        // Frequenza richiesta
+    u8  bits;           // Risoluzione richiesta
+    u8  inc;            // Passo del contatore di fase per tick
+    u32 tick_hz;        // Interrupt al secondo
+    u32 period;         // Cicli per tick
+    u32 load;           // Valore di ricarica del timer (down count: periodo = load + 2)
+    u32 isr_cycles;     // Cicli della ISR usati per validare (0 = non misurati)
+    u32 load_pct;       // Carico CPU della ISR, in percentuale (se misurata)
+} pwm_cfg_t;
+
+// Stati del cambio di configurazione
+#define PWM_RT_IDLE         0
+#define PWM_RT_REQUESTED    1   // Preparata dal main, in attesa dell'ultimo tick
+#define PWM_RT_LOADED       2   // Ricarica scritta, il passo cambia al giro
+
+typedef struct {
+    UINTPTR base;       // AXI Timer del PWM
+    u8  timer;          // Contatore del timer
+    u8  counter;        // Fase del periodo (solo ISR)
+    u8  inc;            // Passo attuale (solo ISR)
+    volatile u8 pending;
+    u8  next_inc;
+    u32 next_load;
+    u8  cmd;            // Comando da seriale in corso (pwm_cfg_command)
+    pwm_cfg_t cfg;      // Configurazione attiva (lato main)
+} pwm_rt_t;
+
+// Prototipi
+int  pwm_cfg_compute(pwm_cfg_t *cfg, u32 freq_hz, u8 bits, u32 isr_cycles);
+void pwm_rt_init(pwm_rt_t *rt, UINTPTR base, u8 timer, u32 isr_cycles);
+int  pwm_rt_request(pwm_rt_t *rt, const pwm_cfg_t *cfg);
+void pwm_cfg_print(const pwm_cfg_t *cfg);
+void pwm_cfg_table(u32 isr_cycles);
+int  pwm_cfg_set(pwm_rt_t *rt, u32 freq_hz, u8 bits, u32 isr_cycles);
+int  pwm_cfg_command(pwm_rt_t *rt, u8 c, u32 isr_cycles);
+int  pwm_cfg_console(pwm_rt_t *rt, const s32 *argv, u8 argc, u32 isr_cycles);
+
+// Annulla un "w" in sospeso. Per i moduli con la console a parole, che
+// non passa la fine riga al gestore dei tasti (pwm_cfg_command non la vede)
+static inline void pwm_cfg_cancel(pwm_rt_t *rt)
+{
+    rt->cmd = 0;
+}
+
+// Esito di pwm_cfg_set, pwm_cfg_command e pwm_cfg_console
+#define PWM_CMD_NONE        0   // Byte non suo
+#define PWM_CMD_USED        1   // Byte consumato
+#define PWM_CMD_CHANGED     2   // Nuova configurazione richiesta
+
+// Un tick del PWM, dalla ISR: restituisce la fase da confrontare con i duty
+static inline u8 pwm_rt_tick(pwm_rt_t *rt)
+{
+    u8 c = rt->counter + rt->inc;
+    rt->counter = c;
+
+    if (rt->pending == PWM_RT_REQUESTED) {
+        // Ultimo tick del periodo: la nuova ricarica vale dal prossimo
+        if ((u8)(c + rt->inc) == 0) {
+            XTmrCtr_SetLoadReg(rt->base, rt->timer, rt->next_load);
+            rt->pending = PWM_RT_LOADED;
+        }
+    } else if (rt->pending == PWM_RT_LOADED) {
+        // Primo tick del nuovo periodo (c == 0): nuovo passo
+        rt->inc = rt->next_inc;
+        rt->pending = PWM_RT_IDLE;
+    }
+    return c;
+}
+
+#endif
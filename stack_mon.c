@@ -0,0 +1,60 @@
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "stack_mon.h"
+#include "isr_budget.h"
+
+// Simboli del linker script (lscript.ld)
+extern u32 _stack_end[];    // Indirizzo più basso dello stack
+extern u32 _stack[];        // Cima dello stack (lo stack cresce verso il basso)
+
+// Margine sotto lo stack pointer corrente lasciato intatto durante la pittura
+#define STACK_PAINT_MARGIN  64
+
+static inline u32 *current_sp(void)
+{
+    u32 *sp;
+#ifdef __MICROBLAZE__
+    __asm__ volatile ("addik %0, r1, 0" : "=r"(sp));
+#else
+    sp = (u32 *)__builtin_frame_address(0);
+#endif
+    return sp;
+}
+
+// Dipinge lo stack libero dal fondo fino a poco sotto lo stack pointer
+void stack_paint(void)
+{
+    u32 *p = _stack_end;
+    u32 *limit = (u32 *)((u8 *)current_sp() - STACK_PAINT_MARGIN);
+
+    while (p < limit)
+        *p++ = STACK_PAINT_WORD;
+}
+
+u32 stack_size(void)
+{
+    return (u32)((u8 *)_stack - (u8 *)_stack_end);
+}
+
+// Cerca dal fondo la prima parola non più uguale al colore di pittura
+u32 stack_high_water(void)
+{
+    u32 *p = _stack_end;
+
+    while (p < _stack && *p == STACK_PAINT_WORD)
+        p++;
+
+    return (u32)((u8 *)_stack - (u8 *)p);
+}
+
+int stack_print(void)
+{
+    u32 size = stack_size();
+    u32 used = stack_high_water();
+    u32 limit = (size / 100) * STACK_BUDGET_PCT;
+
+    xil_printf("Stack: usati %d di %d byte (budget %d) %s\r\n",
+               (int)used, (int)size, (int)limit, (used > limit) ? "FAIL" : "OK");
+
+    return (used > limit) ? XST_FAILURE : XST_SUCCESS;
+}
@@ -0,0 +1,23 @@
+#ifndef STACK_MON_H
+#define STACK_MON_H
+
+#include "xil_types.h"
+
+// --- MONITOR DELLO STACK ---
+// All'avvio lo stack libero viene "dipinto" con un valore noto; più tardi
+// si cerca dal fondo la prima parola sovrascritta: quello è il punto più
+// profondo mai raggiunto (high-water mark), ISR comprese, visto che sul
+// MicroBlaze tutte le interruzioni usano lo stesso stack.
+//
+// I limiti dello stack vengono dal linker script generato da Vitis
+// (_stack_end = fondo, _stack = cima, dimensione _STACK_SIZE).
+
+#define STACK_PAINT_WORD    0x5AA5C33CU
+
+// Prototipi
+void stack_paint(void);         // Da chiamare all'inizio del main, prima di abilitare gli interrupt
+u32  stack_size(void);          // Byte riservati allo stack
+u32  stack_high_water(void);    // Byte usati al massimo dall'avvio
+int  stack_print(void);         // Stampa su seriale, XST_FAILURE oltre il budget
+
+#endif
@@ -0,0 +1,48 @@
+#include "xstatus.h"
+#include "xtmrctr_l.h"
+#include "timebase.h"
+
+// --- INIZIALIZZAZIONE ---
+// Configura i due contatori in cascata come un unico contatore libero a 64 bit.
+// In modalità cascata conta solo il registro di controllo del contatore 0:
+// quello del contatore 1 viene ignorato dall'hardware.
+int timebase_init(void)
+{
+    // Ferma e azzera entrambi i contatori
+    XTmrCtr_SetControlStatusReg(TIMEBASE_BASEADDR, 0, 0);
+    XTmrCtr_SetControlStatusReg(TIMEBASE_BASEADDR, 1, 0);
+    XTmrCtr_SetLoadReg(TIMEBASE_BASEADDR, 0, 0);
+    XTmrCtr_SetLoadReg(TIMEBASE_BASEADDR, 1, 0);
+    XTmrCtr_LoadTimerCounterReg(TIMEBASE_BASEADDR, 0);
+    XTmrCtr_LoadTimerCounterReg(TIMEBASE_BASEADDR, 1);
+    // LoadTimerCounterReg lascia alzato LOAD1: in cascata l'hardware
+    // ignora il CSR del contatore 1, ma lo si rilascia comunque per non
+    // lasciare la parola alta tenuta al valore di carico
+    XTmrCtr_SetControlStatusReg(TIMEBASE_BASEADDR, 1, 0);
+
+    // Cascata + Auto-Reload, conteggio in avanti, nessun interrupt.
+    // Scrivere il CSR senza il bit LOAD lo rilascia e il contatore parte.
+    XTmrCtr_SetControlStatusReg(TIMEBASE_BASEADDR, 0,
+        XTC_CSR_CASC_MASK | XTC_CSR_AUTO_RELOAD_MASK);
+    XTmrCtr_Enable(TIMEBASE_BASEADDR, 0);
+
+    return XST_SUCCESS;
+}
+
+// --- LETTURA CONSISTENTE ---
+// Alto, basso, di nuovo alto: se la parola alta è cambiata nel mezzo,
+// la bassa ha appena fatto il giro e si ripete. Nessun lock e nessuna
+// disabilitazione degli interrupt: si può chiamare anche dalla ISR.
+u64 timebase_now(void)
+{
+    u32 hi, lo, hi2;
+
+    hi = XTmrCtr_GetTimerCounterReg(TIMEBASE_BASEADDR, 1);
+    do {
+        lo  = XTmrCtr_GetTimerCounterReg(TIMEBASE_BASEADDR, 0);
+        hi2 = hi;
+        hi  = XTmrCtr_GetTimerCounterReg(TIMEBASE_BASEADDR, 1);
+    } while (hi != hi2);
+
+    return ((u64)hi << 32) | lo;
+}
@@ -0,0 +1,100 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include "xil_types.h"
+#include "xparameters.h"
+#include "xtmrctr_l.h"
+
+// --- BASE DEI TEMPI A 64 BIT ---
+// Usa i due contatori di un AXI Timer dedicato in modalità CASCATA:
+// il contatore 0 è la parola bassa, il contatore 1 quella alta.
+// Il timer conta in avanti liberamente a TIMEBASE_CLK_HZ senza interrupt,
+// quindi leggere l'ora non costa nessun tick software nella ISR.
+//
+// L'AXI Timer 0 resta ai programmi (PWM, frecce): la base dei tempi
+// richiede un secondo AXI Timer nel block design.
+#ifndef TIMEBASE_BASEADDR
+#ifndef SDT
+#define TIMEBASE_BASEADDR   XPAR_TMRCTR_1_BASEADDR
+#else
+#define TIMEBASE_BASEADDR   XPAR_XTMRCTR_1_BASEADDR
+#endif
+#endif
+
+// Frequenza del clock del timer (100 MHz come nel resto dei programmi)
+#ifndef TIMEBASE_CLK_HZ
+#define TIMEBASE_CLK_HZ     100000000ULL
+#endif
+
+// --- CONVERSIONI CALCOLATE A COMPILE-TIME ---
+// Da unità di tempo a tick: semplice moltiplicazione per una costante.
+#define TB_US_TO_TICKS(us)  ((u64)(us) * (TIMEBASE_CLK_HZ / 1000000ULL))
+#define TB_MS_TO_TICKS(ms)  ((u64)(ms) * (TIMEBASE_CLK_HZ / 1000ULL))
+
+// Da tick a unità di tempo: moltiplicazione per il reciproco in Q0.64
+// (arrotondato per eccesso) tenendo la metà alta del prodotto a 128 bit.
+// Le divisioni qui sotto sono tutte tra costanti: nessuna divisione a runtime.
+#define TB_RECIP_Q64(unit) \
+    ((((((u64)(unit) << 32) / TIMEBASE_CLK_HZ) << 32) | \
+      (((((u64)(unit) << 32) % TIMEBASE_CLK_HZ) << 32) / TIMEBASE_CLK_HZ)) + 1)
+#define TB_US_MULT          TB_RECIP_Q64(1000000ULL)
+#define TB_MS_MULT          TB_RECIP_Q64(1000ULL)
+// Per i nanosecondi il fattore è > 1: si usa un Q16.16
+#define TB_NS_MULT_Q16      ((u32)((1000000000ULL << 16) / TIMEBASE_CLK_HZ))
+
+// Prototipi
+int  timebase_init(void);
+u64  timebase_now(void);
+
+// Parola bassa del contatore: basta per misurare intervalli brevi
+// (fino a ~42 s a 100 MHz) con un solo accesso al bus.
+static inline u32 timebase_now32(void)
+{
+    return XTmrCtr_GetTimerCounterReg(TIMEBASE_BASEADDR, 0);
+}
+
+// Metà alta di ticks * mult (64x64 -> 128 bit) con quattro prodotti 32x32
+static inline u64 tb_scale(u64 ticks, u64 mult)
+{
+    u32 ah = (u32)(ticks >> 32), al = (u32)ticks;
+    u32 bh = (u32)(mult >> 32),  bl = (u32)mult;
+    u64 ll = (u64)al * bl;
+    u64 lh = (u64)al * bh;
+    u64 hl = (u64)ah * bl;
+    u64 mid = (ll >> 32) + (u32)lh + (u32)hl;
+
+    return (u64)ah * bh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+static inline u64 timebase_ticks_to_us(u64 ticks) { return tb_scale(ticks, TB_US_MULT); }
+static inline u64 timebase_ticks_to_ms(u64 ticks) { return tb_scale(ticks, TB_MS_MULT); }
+
+// Per intervalli (u32): restituisce i ns senza divisioni
+static inline u64 timebase_ticks_to_ns(u32 ticks)
+{
+    return ((u64)ticks * TB_NS_MULT_Q16) >> 16;
+}
+
+static inline u64 timebase_now_us(void) { return timebase_ticks_to_us(timebase_now()); }
+static inline u64 timebase_now_ms(void) { return timebase_ticks_to_ms(timebase_now()); }
+
+// --- SCADENZE ---
+// Una scadenza è un istante assoluto in tick. Il confronto con segno
+// resta corretto anche al giro del contatore.
+static inline u64 timebase_deadline(u64 ticks_from_now)
+{
+    return timebase_now() + ticks_from_now;
+}
+
+static inline int timebase_expired(u64 deadline)
+{
+    return (s64)(timebase_now() - deadline) >= 0;
+}
+
+// Versione a 32 bit per le scadenze brevi (debounce, lampeggio)
+static inline int timebase_expired32(u32 deadline)
+{
+    return (s32)(timebase_now32() - deadline) >= 0;
+}
+
+#endif
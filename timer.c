@@ -2,6 +2,10 @@
 #include "xtmrctr_l.h"
 #include "xil_printf.h"
 #include "xparameters.h"
+#include "gpio_shadow.h"
+#include "isr_prof.h"
+#include "isr_budget.h"
+#include "app_core.h"
 
 // Configurazione indirizzo base del Timer a seconda dell'ambiente (SDT o standard)
 #ifndef SDT
@@ -14,39 +18,41 @@
 
 // --- Memory Mapped I/O Pointers ---
 // Puntatori diretti agli indirizzi fisici delle periferiche (GPIO e Interrupt Controller)
-volatile int * gpio_0_data = (volatile int *)0x40000000; // Pointer to GPIO 0 Data register (e.g., LEDs)
+static gpio_shadow_t gpio_0 = GPIO_SHADOW_INIT(0x40000000); // GPIO 0 Data register (e.g., LEDs), via copia ombra
 
+// Misura dei cicli della ISR (attiva solo con ISR_PROFILE)
+static isr_prof_t prof_isr = ISR_PROF_INIT;
 
-// Interrupt Controller (INTC) Registers
-volatile int * IER = (volatile int*)	0x41200008; // Interrupt Enable Register
-volatile int * MER = (volatile int*)	0x4120001C; // Master Enable Register
 
-volatile int * IISR = (volatile int*)	0x41200000; // Interrupt Status Register (Read pending interrupts)
-volatile int * IIAR = (volatile int*)	0x4120000C; // Interrupt Acknowledge Register
+// Corpo della ISR: la myISR del nucleo (con l'attributo interrupt_handler,
+// che usa rtid invece di un return normale) la chiama con lo stato dell'INTC
+static void TimerISR(u32 p);
 
+static int TimerInit(void);
+static void TimerStep(void);
+static void TimerStop(void);
+static int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TimerCounter);
 
-// Dichiarazione della funzione ISR con attributo specifico per MicroBlaze
-// Questo dice al compilatore di usare l'istruzione di ritorno da interrupt (rtid) invece di un return normale
-void myISR(void) __attribute__((interrupt_handler));
+// Modulo del nucleo (app_core.h)
+const app_module_t app_timer = { "lampeggio", TimerInit, TimerStep, TimerISR, NULL, TimerStop };
 
-int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TimerCounter);
+#ifndef APP_SINGLE_IMAGE
+APP_STANDALONE_MAIN(app_timer)
+#endif
 
-int main(void)
+static int TimerInit(void)
 {
 	int Status;
 
+    // Allinea la copia ombra e il registro dei LED
+    gpio_sh_write(&gpio_0, 0x0);
+
 	/*
 	 * Setup dell'Interrupt Controller (INTC)
 	 */
-    // Abilita la linea di interrupt specifica per il Timer
-    *IER = XPAR_AXI_TIMER_0_INTERRUPT_MASK; 
-
-    // Abilita il Master Enable dell'Interrupt Controller
-    // 0x3 = 0b00...0011 -> Imposta i bit MER (Master Enable) e HIE (Hardware Interrupt Enable)
-    *MER = 0x3; 
-
-    // Abilita gli interrupt a livello di CPU MicroBlaze (bit IE nel registro MSR)
-    microblaze_enable_interrupts();
+    // Abilita la linea di interrupt specifica per il Timer.
+    // MER e interrupt della CPU li ha già accesi il nucleo.
+    app_core_irq_enable(XPAR_AXI_TIMER_0_INTERRUPT_MASK);
 
     // Configura e avvia il Timer
 	Status = TmrCtrLowLevelExample(TMRCTR_BASEADDR, TIMER_COUNTER_0);
@@ -55,14 +61,23 @@ int main(void)
 		return XST_FAILURE;
 	}
 
-    // Loop infinito. Il resto dell'esecuzione avviene all'interno di myISR quando il timer scade.
-	while(1);
-
-	xil_printf("Successfully ran Tmrctr lowlevel Example\r\n");
 	return XST_SUCCESS;
 }
 
-int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TmrCtrNumber)
+// Un giro del loop. Il resto dell'esecuzione avviene nella ISR quando il timer scade.
+static void TimerStep(void)
+{
+    ISR_PROF_CHECK("timer myISR", prof_isr, ISR_BUDGET_TIMER);
+}
+
+// Arresto: timer fermo e LED spenti
+static void TimerStop(void)
+{
+    app_core_timer_stop(TMRCTR_BASEADDR, TIMER_COUNTER_0);
+    gpio_sh_write(&gpio_0, 0x0);
+}
+
+static int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TmrCtrNumber)
 {
 	u32 Value1;
 	u32 Value2;
@@ -96,10 +111,10 @@ int TmrCtrLowLevelExample(UINTPTR TmrCtrBaseAddress, u8 TmrCtrNumber)
 }
 
 // Routine di servizio dell'interrupt (eseguita quando scatta l'interrupt hardware)
-void myISR(void)
+// p = stato dell'Interrupt Controller, per capire chi ha chiamato
+static void TimerISR(u32 p)
 {
-    // Legge lo stato dell'Interrupt Controller per capire chi ha chiamato
-    unsigned p = *IISR; 
+    ISR_PROF_BEGIN(t_isr);
     
     // Verifica se l'interrupt è stato causato dall'AXI Timer
     if (p & XPAR_AXI_TIMER_0_INTERRUPT_MASK) {
@@ -111,13 +126,15 @@ void myISR(void)
 
         // --- 2. Pulisce l'interrupt sul Controller (INTC) ---
         // Scrive nel registro Acknowledge (IIAR) per confermare la gestione
-        *IIAR |= XPAR_AXI_TIMER_0_INTERRUPT_MASK;
+        *IIAR = XPAR_AXI_TIMER_0_INTERRUPT_MASK;
 
         // --- 3. Azione utente: Toggle GPIO ---
-        // Legge il valore all'indirizzo 0x40000000 (GPIO LEDs), ne inverte i bit (~) e riscrive.
-        // Questo fa lampeggiare i LED.
-        *((int*)0x40000000) = ~(*((int*)0x40000000));
+        // Inverte tutti i bit della copia ombra dei LED e la scrive sul GPIO:
+        // una sola scrittura sul bus, nessuna lettura. Questo fa lampeggiare i LED.
+        gpio_sh_toggle(&gpio_0, 0xFFFFFFFF);
     }
+
+    ISR_PROF_END(prof_isr, t_isr);
 }
 
 
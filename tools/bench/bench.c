@@ -0,0 +1,268 @@
+// Banco di prova dell'immagine unica su QEMU (tools/bench): gli stessi
+// sorgenti della scheda, compilati con mb-gcc, girano sul MicroBlaze
+// emulato con periferiche finte (RAM, vedi crt0.S). Il banco prepara i
+// registri come li troverebbe la ISR, chiama i moduli attraverso il nucleo
+// e delimita ogni caso con BENCH_BEGIN/BENCH_END (bench.h).
+//
+// Casi misurati, per modulo:
+//   - avvio fino al primo modulo (le fasi le ricava bench_report.py dalle
+//     scritture di boot_mark) e cambio di modulo (stop + init)
+//   - la myISR del nucleo intera (prologo ed epilogo compresi) per ogni
+//     ramo: tick PWM, lampeggio, fronte dei pulsanti, tick di riarmo
+//   - i byte dalla seriale: tasti singoli e comandi a parole
+//   - il passo del loop e il lavoro differito
+// Le stampe dei moduli escono sulla console di QEMU con la xil_printf
+// ridotta di bsp.c: i casi che stampano non sono confrontabili con la
+// scheda e non ce ne sono nei percorsi caldi.
+//
+// Alla fine stampa la tabella "BENCH <id> <nome>" e "BENCH FINE".
+
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xtmrctr_l.h"
+#include "xil_printf.h"
+#include "app_core.h"
+#include "dpc.h"
+#include "bench.h"
+
+volatile u32 bench_begin[BENCH_N] = { 1 };
+volatile u32 bench_end[BENCH_N] = { 1 };
+
+static const char *bench_names[BENCH_N] = { "avvio.reset_main" };
+static int bench_count = 1;
+
+// Moduli nell'ordine di app_main.c
+extern const app_module_t app_fsm, app_pwm, app_rgb, app_rover, app_buttons, app_timer;
+
+static const app_module_t *const apps[] = {
+    &app_fsm,
+    &app_pwm,
+    &app_rgb,
+    &app_rover,
+    &app_buttons,
+    &app_timer,
+};
+#define N_APPS  ((int)(sizeof(apps) / sizeof(apps[0])))
+
+// --- REGISTRI FINTI ---
+#define REG(a)          (*(volatile u32 *)(a))
+#define INTC_IISR       REG(0x41200000)
+#define TMR_CSR(n)      REG(XPAR_TMRCTR_0_BASEADDR + (n) * XTC_TIMER_COUNTER_OFFSET)
+#define TB_TCR(n)       REG(XPAR_TMRCTR_1_BASEADDR + (n) * XTC_TIMER_COUNTER_OFFSET + XTC_TCR_OFFSET)
+#define BTN1_DATA       REG(0x40060000)
+#define BTN1_IPISR      REG(0x40060120)
+#define BTN2_DATA       REG(0x40050000)
+#define BTN2_IPISR      REG(0x40050120)
+
+#define TICKS_PER_MS    100000
+
+static u64 bench_now;   // Base dei tempi finta, in tick a 100 MHz
+
+// Porta avanti la base dei tempi (i due contatori in cascata)
+static void bench_time(u64 ticks)
+{
+    bench_now += ticks;
+    TB_TCR(0) = (u32)bench_now;
+    TB_TCR(1) = (u32)(bench_now >> 32);
+}
+
+static int bench_case(const char *name)
+{
+    if (bench_count >= BENCH_N) {
+        xil_printf("BENCH ERRORE troppi casi\r\n");
+        return BENCH_N - 1;
+    }
+    bench_names[bench_count] = name;
+    return bench_count++;
+}
+
+// Interruzione come la vede la CPU: IISR con le linee in attesa, poi la
+// myISR del nucleo, che torna con rtid a r14
+void myISR(void);
+
+static void bench_irq(int id, u32 pending)
+{
+    INTC_IISR = pending;
+    BENCH_BEGIN(id);
+    __asm__ volatile (
+        "addik  r14, r0, 1f\n\t"
+        "brid   myISR\n\t"
+        "nop\n"
+        "1:\n"
+        ::: "r14", "memory");
+    BENCH_END(id);
+}
+
+// Tick di un contatore dell'AXI Timer: il bit di interrupt si azzera
+// scrivendolo a 1, qui dopo la chiamata
+static void bench_timer_irq(int id, u32 counters)
+{
+    if (counters & 1) TMR_CSR(0) |= XTC_CSR_INT_OCCURED_MASK;
+    if (counters & 2) TMR_CSR(1) |= XTC_CSR_INT_OCCURED_MASK;
+    bench_irq(id, XPAR_AXI_TIMER_0_INTERRUPT_MASK);
+    TMR_CSR(0) &= ~XTC_CSR_INT_OCCURED_MASK;
+    TMR_CSR(1) &= ~XTC_CSR_INT_OCCURED_MASK;
+    bench_time(400);
+}
+
+static void bench_bytes(int id, const app_module_t *m, const char *s)
+{
+    for (; *s; s++) {
+        BENCH_BEGIN(id);
+        m->on_byte((u8)*s);
+        BENCH_END(id);
+    }
+}
+
+static void bench_step(int id, const app_module_t *m, int n)
+{
+    while (n--) {
+        BENCH_BEGIN(id);
+        m->step();
+        BENCH_END(id);
+    }
+}
+
+static void bench_dpc(int id)
+{
+    BENCH_BEGIN(id);
+    dpc_run();
+    BENCH_END(id);
+}
+
+static void bench_switch(int index, const char *name)
+{
+    int id = bench_case(name);
+
+    BENCH_BEGIN(id);
+    app_core_switch(index);
+    BENCH_END(id);
+}
+
+// Due periodi PWM a 8 bit, per vedere anche la fine periodo
+#define PWM_TICKS   512
+
+static void bench_pwm(void)
+{
+    int tick = bench_case("pwm.isr_tick");
+    int i;
+
+    bench_switch(1, "pwm.cambio");
+    for (i = 0; i < PWM_TICKS; i++)
+        bench_timer_irq(tick, 1);
+}
+
+static void bench_rgb(void)
+{
+    int tick = bench_case("rgb.isr_tick");
+    int i;
+
+    bench_switch(2, "rgb.cambio");
+    bench_bytes(bench_case("rgb.tasto_colore"), &app_rgb, "1234567890");
+    bench_bytes(bench_case("rgb.parola_rgb"), &app_rgb, "rgb 255 128 0\r");
+    bench_step(bench_case("rgb.passo"), &app_rgb, 16);
+    for (i = 0; i < PWM_TICKS; i++)
+        bench_timer_irq(tick, 1);
+}
+
+static void bench_rover(void)
+{
+    int tick = bench_case("rover.isr_tick");
+    int key = bench_case("rover.tasto");
+    int i;
+
+    bench_switch(3, "rover.cambio");
+    bench_dpc(bench_case("rover.banner_dpc"));
+    bench_bytes(key, &app_rover, "fblrqezcs");
+    bench_bytes(bench_case("rover.parola_vel"), &app_rover, "vel 120 -80\r");
+
+    // Con le rampe in corso e a regime
+    for (i = 0; i < PWM_TICKS; i++)
+        bench_timer_irq(tick, 1);
+    bench_bytes(key, &app_rover, "f");
+    for (i = 0; i < PWM_TICKS; i++)
+        bench_timer_irq(tick, 1);
+
+    // Lampeggio delle frecce insieme al tick, poi il suo lavoro differito
+    bench_bytes(key, &app_rover, "l");
+    bench_timer_irq(bench_case("rover.isr_tick_lampeggio"), 3);
+    bench_dpc(bench_case("rover.lampeggio_dpc"));
+}
+
+// Un tasto premuto per 10 ms, tick di riarmo ogni ms fino a 40 ms
+static void bench_buttons(void)
+{
+    int edge = bench_case("pulsanti.isr_fronte");
+    int tick = bench_case("pulsanti.isr_tick");
+    int ms;
+
+    bench_switch(4, "pulsanti.cambio");
+    BTN1_DATA = 1;
+    BTN1_IPISR = 1;
+    bench_irq(edge, XPAR_BUTTON_IP2INTC_IRPT_MASK);
+    BTN1_IPISR = 0;
+    for (ms = 0; ms < 40; ms++) {
+        if (ms == 10)
+            BTN1_DATA = 0;
+        bench_time(TICKS_PER_MS);
+        TMR_CSR(0) |= XTC_CSR_INT_OCCURED_MASK;
+        bench_irq(tick, XPAR_AXI_TIMER_0_INTERRUPT_MASK);
+        TMR_CSR(0) &= ~XTC_CSR_INT_OCCURED_MASK;
+    }
+    BTN2_DATA = 1;
+    BTN2_IPISR = 1;
+    bench_irq(edge, XPAR_GPIO_IP2INTC_IRPT_MASK);
+    BTN2_IPISR = 0;
+    BTN2_DATA = 0;
+}
+
+static void bench_timer(void)
+{
+    int tick = bench_case("lampeggio.isr_tick");
+    int i;
+
+    bench_switch(5, "lampeggio.cambio");
+    for (i = 0; i < 4; i++)
+        bench_timer_irq(tick, 1);
+}
+
+static void bench_fsm(void)
+{
+    int tick = bench_case("frecce.isr_tick");
+    int i;
+
+    // Il modulo 0 è già attivo dall'avvio
+    for (i = 0; i < 4; i++)
+        bench_timer_irq(tick, 1);
+    bench_step(bench_case("frecce.passo"), &app_fsm, 16);
+}
+
+int main(void)
+{
+    int i, start;
+
+    BENCH_END(BENCH_RESET);
+    start = bench_case("avvio.app_core_start");
+
+    BENCH_BEGIN(start);
+    if (app_core_start(apps, N_APPS) != XST_SUCCESS)
+        xil_printf("BENCH ERRORE avvio\r\n");
+    BENCH_END(start);
+
+    bench_fsm();
+    bench_pwm();
+    bench_rgb();
+    bench_rover();
+    bench_buttons();
+    bench_timer();
+
+    // Costo dei segni stessi, che bench_report.py sottrae
+    i = bench_case("bench.vuoto");
+    BENCH_BEGIN(i);
+    BENCH_END(i);
+
+    for (i = 0; i < bench_count; i++)
+        xil_printf("BENCH %d %s\r\n", i, bench_names[i]);
+    xil_printf("BENCH FINE\r\n");
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// --- BANCO DI PROVA SU QEMU (tools/bench) ---
+// Il programma gira su qemu-system-microblazeel con il plugin execlog,
+// che scrive ogni istruzione eseguita e ogni accesso in memoria. Un caso
+// misurato è delimitato da due scritture: bench_begin[id] e bench_end[id].
+// bench_report.py conta le istruzioni, gli accessi alle periferiche e i
+// salti presi tra le due, per ogni invocazione.
+
+// Console vera di QEMU (UART Lite della petalogix-s3adsp1800)
+#define BENCH_CONSOLE   0x84000000
+
+// Casi al massimo; il caso 0 è l'avvio, aperto da crt0.S
+#define BENCH_N         64
+#define BENCH_RESET     0
+
+#ifndef __ASSEMBLER__
+#include "xil_types.h"
+
+// In .data: l'azzeramento del .bss in crt0.S non deve sembrare un segno
+extern volatile u32 bench_begin[BENCH_N];
+extern volatile u32 bench_end[BENCH_N];
+
+#define BENCH_BEGIN(id) (bench_begin[(id)] = 0)
+#define BENCH_END(id)   (bench_end[(id)] = 0)
+
+void bench_putc(char c);
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+#!/bin/sh
+# Banco di prova dell'immagine unica su QEMU (tools/bench/bench.c).
+#
+# Compila con mb-gcc tutti i sorgenti dell'immagine unica (tranne
+# app_main.c) più il banco, lo esegue su qemu-system-microblazeel
+# (petalogix-s3adsp1800) con il plugin execlog e passa il log a
+# bench_report.py, che per ogni caso conta istruzioni, accessi AXI e salti
+# presi (tabella a schermo e in $OUT/bench_results.txt), insieme alle fasi
+# dell'avvio contate dal reset.
+#
+# Il confronto è con tools/bench/baseline.txt: istruzioni massime o
+# accessi AXI cresciuti sono una regressione (uscita 1). Senza baseline, o
+# con una di un altro compilatore o di altre opzioni, l'uscita è 2.
+#
+# Uso:
+#   QEMU_PLUGIN=<qemu>/build/contrib/plugins/libexeclog.so tools/bench/bench.sh            confronto
+#   QEMU_PLUGIN=<qemu>/build/contrib/plugins/libexeclog.so tools/bench/bench.sh --update   riscrive la baseline
+#
+# Variabili: MB_PREFIX (default mb-), CFLAGS (default come mem_report.sh),
+#            QEMU (default qemu-system-microblazeel),
+#            QEMU_PLUGIN (libexeclog.so, obbligatoria: "make plugins" nei
+#            sorgenti di QEMU), BENCH_TIMEOUT (secondi, default 120).
+#
+# La baseline va nel repository: la prima si genera con --update con lo
+# stesso mb-gcc e le stesse CFLAGS della scheda e si include nel commit;
+# una modifica che la cambia apposta la riscrive nello stesso commit.
+#
+# Le istruzioni non sono cicli: per il MicroBlaze a 5 stadi la stima è
+# istruzioni + salti presi x penalità + accessi AXI x latenza del bus, con
+# la latenza da misurare sulla scheda (tools/pwm_load.py la usa così).
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+BENCH="$ROOT/tools/bench"
+BASELINE="$BENCH/baseline.txt"
+OUT="${OUT:-$ROOT/_bench_build}"
+CC="${MB_PREFIX-mb-}gcc"
+NM="${MB_PREFIX-mb-}nm"
+CFLAGS="${CFLAGS:--O2 -mlittle-endian -mcpu=v11.0 -mxl-soft-mul}"
+QEMU="${QEMU:-qemu-system-microblazeel}"
+BENCH_TIMEOUT="${BENCH_TIMEOUT:-120}"
+
+if [ -z "$QEMU_PLUGIN" ]; then
+    echo "QEMU_PLUGIN non impostata (libexeclog.so dei plugin di QEMU)" >&2
+    exit 2
+fi
+
+UPDATE=""
+[ "$1" = "--update" ] && UPDATE="--update"
+
+# Unità del MicroBlaze dalle opzioni, come le vede fixmath.h
+HW="-DXPAR_MICROBLAZE_USE_HW_MUL=1"
+case " $CFLAGS " in *" -mxl-soft-mul "*) HW="-DXPAR_MICROBLAZE_USE_HW_MUL=0";; esac
+case " $CFLAGS " in *" -mxl-multiply-high "*) HW="-DXPAR_MICROBLAZE_USE_HW_MUL=2";; esac
+case " $CFLAGS " in *" -mno-xl-soft-div "*) HW="$HW -DXPAR_MICROBLAZE_USE_DIV=1";; esac
+case " $CFLAGS " in *" -mxl-barrel-shift "*) HW="$HW -DXPAR_MICROBLAZE_USE_BARREL=1";; esac
+case " $CFLAGS " in *" -mhard-float "*) HW="$HW -DXPAR_MICROBLAZE_USE_FPU=1";; esac
+
+rm -rf "$OUT"
+mkdir -p "$OUT"
+
+# Tutti i sorgenti dell'immagine unica: il main è quello del banco
+SRCS=""
+for f in "$ROOT"/*.c; do
+    [ "$(basename "$f")" = app_main.c ] || SRCS="$SRCS $f"
+done
+
+# shellcheck disable=SC2086
+$CC $CFLAGS $HW -DAPP_SINGLE_IMAGE -nostdlib -T "$BENCH/bench.ld" \
+    -I"$BENCH" -I"$BENCH/bsp" -I"$ROOT" \
+    "$BENCH/crt0.S" "$BENCH/bsp.c" "$BENCH/bench.c" $SRCS -lgcc \
+    -o "$OUT/bench.elf"
+$NM -S "$OUT/bench.elf" > "$OUT/bench.nm"
+
+# QEMU non esce da solo: si ferma quando il banco ha stampato la fine
+: > "$OUT/serial.txt"
+"$QEMU" -M petalogix-s3adsp1800 -display none -monitor none \
+    -serial file:"$OUT/serial.txt" -kernel "$OUT/bench.elf" \
+    -plugin "$QEMU_PLUGIN" -d plugin -D "$OUT/exec.log" &
+pid=$!
+t=0
+until grep -q "BENCH FINE" "$OUT/serial.txt"; do
+    if ! kill -0 $pid 2>/dev/null || [ $t -ge "$BENCH_TIMEOUT" ]; then
+        kill $pid 2>/dev/null || true
+        echo "Il banco non è arrivato alla fine (uscita in $OUT/serial.txt)" >&2
+        exit 2
+    fi
+    sleep 1
+    t=$((t + 1))
+done
+kill $pid
+wait $pid 2>/dev/null || true
+grep "BENCH ERRORE" "$OUT/serial.txt" >&2 && exit 2
+
+# I numeri valgono solo per lo stesso compilatore con le stesse opzioni
+TOOLCHAIN="# cc: $($CC --version | head -1) | cflags: $CFLAGS"
+python3 "$BENCH/bench_report.py" --log "$OUT/exec.log" --nm "$OUT/bench.nm" \
+    --serial "$OUT/serial.txt" --toolchain "$TOOLCHAIN" \
+    --out "$OUT/bench_results.txt" --baseline "$BASELINE" $UPDATE
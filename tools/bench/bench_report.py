@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+# Rapporto del banco di prova su QEMU (tools/bench/bench.sh).
+#
+# Legge il log del plugin execlog (una riga per istruzione eseguita, con
+# gli accessi in memoria), i simboli di bench.elf e l'uscita seriale del
+# banco, e per ogni caso di bench.c conta tra BENCH_BEGIN e BENCH_END:
+#   istr    istruzioni eseguite (imm compresi: sul MicroBlaze è un'istruzione)
+#   AXI     letture e scritture nelle pagine delle periferiche (0x40000000
+#           e 0x41000000, bsp/xparameters.h)
+#   salti   salti presi (l'istruzione dopo non è quella successiva)
+# e ne stampa minimo, media e massimo sulle invocazioni. Il costo dei segni
+# stessi (caso bench.vuoto) è già tolto.
+#
+# Le fasi dell'avvio si contano dal reset: "uscite_sicure" è la prima
+# istruzione fuori da boot_fast_start (che non chiama niente prima di aver
+# scritto le uscite), le altre sono la prima scrittura di boot_seen[fase]
+# (boot_mark), nell'ordine di boot.h.
+#
+# Uso:
+#   bench_report.py --log exec.log --nm bench.nm --serial serial.txt \
+#       --toolchain "<riga>" --out risultati.txt [--baseline f [--update]]
+#
+# Con --baseline confronta istr massime e accessi AXI con la baseline:
+# un valore cresciuto è una regressione (uscita 1); baseline assente o di
+# un altro compilatore: uscita 2. Con --update la riscrive.
+
+import argparse
+import os
+import re
+import sys
+
+PERIPH_LO = 0x40000000
+PERIPH_HI = 0x42000000
+BENCH_N = 64                # bench.h
+
+LINE = re.compile(r'^\d+, 0x([0-9a-fA-F]+), ')
+MEM = re.compile(r'(load|store), 0x([0-9a-fA-F]+)')
+BOOT_PH = re.compile(r'^\s*BOOT_PH_(\w+),')
+
+
+def read_symbols(path):
+    """nm -S: nome -> (indirizzo, dimensione)"""
+    syms = {}
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if len(parts) == 4:
+                syms[parts[3]] = (int(parts[0], 16), int(parts[1], 16))
+            elif len(parts) == 3:
+                syms[parts[2]] = (int(parts[0], 16), 0)
+    return syms
+
+
+def read_cases(path):
+    names = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = re.match(r'BENCH (\d+) (\S+)', line.strip())
+            if m:
+                names[int(m.group(1))] = m.group(2)
+    return names
+
+
+def boot_phases(root):
+    phases = []
+    with open(os.path.join(root, "boot.h")) as f:
+        for line in f:
+            m = BOOT_PH.match(line)
+            if m:
+                phases.append(m.group(1).lower())
+    return phases
+
+
+class Stat:
+    def __init__(self):
+        self.n = 0
+        self.total = 0
+        self.imin = None
+        self.imax = 0
+        self.rd = 0
+        self.wr = 0
+        self.br = 0
+
+    def add(self, istr, rd, wr, br):
+        self.n += 1
+        self.total += istr
+        self.imin = istr if self.imin is None else min(self.imin, istr)
+        self.imax = max(self.imax, istr)
+        self.rd = max(self.rd, rd)
+        self.wr = max(self.wr, wr)
+        self.br = max(self.br, br)
+
+    def row(self, name, base):
+        return "%s %d %d %d %d %d %d %d" % (
+            name, self.n, self.imin - base, self.total // self.n - base,
+            self.imax - base, self.rd, self.wr, self.br)
+
+
+def analyse(log, syms, phases):
+    begin = syms["bench_begin"][0]
+    end = syms["bench_end"][0]
+    seen = syms["boot_seen"][0]
+    fast, fast_size = syms["boot_fast_start"]
+
+    n = rd = wr = br = 0
+    prev = None
+    reset = None            # Contatori al segno di reset
+    open_ = {}
+    stats = {}
+    marks = {}              # Fase -> contatori dal reset
+    in_fast = False
+
+    with open(log, errors="replace") as f:
+        for line in f:
+            m = LINE.match(line)
+            if not m:
+                continue
+            pc = int(m.group(1), 16)
+            n += 1
+            if prev is not None and pc != prev + 4:
+                br += 1
+            prev = pc
+
+            if fast <= pc < fast + fast_size:
+                in_fast = True
+            elif in_fast and "uscite_sicure" not in marks and reset:
+                marks["uscite_sicure"] = (n - 1 - reset[0], rd - reset[1],
+                                          wr - reset[2], br - reset[3])
+
+            for kind, addr in MEM.findall(line):
+                a = int(addr, 16)
+                if PERIPH_LO <= a < PERIPH_HI:
+                    if kind == "load":
+                        rd += 1
+                    else:
+                        wr += 1
+                if kind != "store":
+                    continue
+                if begin <= a < begin + 4 * BENCH_N:
+                    idx = (a - begin) // 4
+                    open_[idx] = (n, rd, wr, br)
+                    if idx == 0 and reset is None:
+                        reset = (n, rd, wr, br)
+                elif end <= a < end + 4 * BENCH_N:
+                    idx = (a - end) // 4
+                    if idx in open_:
+                        s0 = open_.pop(idx)
+                        stats.setdefault(idx, Stat()).add(
+                            n - s0[0], rd - s0[1], wr - s0[2], br - s0[3])
+                elif seen <= a < seen + len(phases) and in_fast:
+                    ph = phases[a - seen]
+                    if ph not in marks:
+                        marks[ph] = (n - reset[0], rd - reset[1],
+                                     wr - reset[2], br - reset[3])
+    return stats, marks
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--log", required=True)
+    ap.add_argument("--nm", required=True)
+    ap.add_argument("--serial", required=True)
+    ap.add_argument("--toolchain", required=True)
+    ap.add_argument("--out", required=True)
+    ap.add_argument("--baseline")
+    ap.add_argument("--update", action="store_true")
+    args = ap.parse_args()
+
+    root = os.path.normpath(os.path.join(os.path.dirname(__file__), "..", ".."))
+    syms = read_symbols(args.nm)
+    names = read_cases(args.serial)
+    phases = boot_phases(root)
+    stats, marks = analyse(args.log, syms, phases)
+
+    if not names or "bench.vuoto" not in names.values():
+        print("Uscita seriale del banco incompleta (manca la tabella dei casi)",
+              file=sys.stderr)
+        return 2
+
+    empty = [i for i, nm in names.items() if nm == "bench.vuoto"][0]
+    base = stats[empty].imin if empty in stats else 0
+
+    rows = [args.toolchain,
+            "# caso n istr_min istr_media istr_max axi_letture axi_scritture salti"]
+    for ph in ["uscite_sicure"] + phases:
+        if ph in marks:
+            i, r, w, b = marks[ph]
+            rows.append("avvio.%s 1 %d %d %d %d %d %d" % (ph, i, i, i, r, w, b))
+    for idx in sorted(stats):
+        if idx == empty:
+            continue
+        rows.append(stats[idx].row(names.get(idx, "caso%d" % idx), base))
+
+    with open(args.out, "w") as f:
+        f.write("\n".join(rows) + "\n")
+    print("%-28s %5s %7s %7s %7s %5s %5s %5s" % (
+        "caso", "n", "min", "media", "max", "AXI L", "AXI S", "salti"))
+    for r in rows[2:]:
+        p = r.split()
+        print("%-28s %5s %7s %7s %7s %5s %5s %5s" % tuple(p))
+
+    if not args.baseline:
+        return 0
+    if args.update:
+        with open(args.baseline, "w") as f:
+            f.write("\n".join(rows) + "\n")
+        print("Baseline scritta in %s" % args.baseline)
+        return 0
+    if not os.path.exists(args.baseline):
+        print("Manca %s: crearla con --update" % args.baseline, file=sys.stderr)
+        return 2
+    with open(args.baseline) as f:
+        blines = f.read().splitlines()
+    if not blines or blines[0] != args.toolchain:
+        print("Baseline di un altro compilatore o di altre opzioni:", file=sys.stderr)
+        print("  baseline: %s" % (blines[0] if blines else ""), file=sys.stderr)
+        print("  ora:      %s" % args.toolchain, file=sys.stderr)
+        print("Rigenerarla con --update prima di confrontare", file=sys.stderr)
+        return 2
+
+    old = {}
+    for line in blines[1:]:
+        if line.startswith("#"):
+            continue
+        p = line.split()
+        old[p[0]] = [int(x) for x in p[1:]]
+
+    # Le istruzioni massime e gli accessi al bus possono solo restare
+    # uguali o scendere
+    print("=== Confronto con la baseline")
+    status = 0
+    for r in rows[2:]:
+        p = r.split()
+        name, new = p[0], [int(x) for x in p[1:]]
+        if name not in old:
+            print("%s: assente nella baseline" % name)
+            continue
+        fail = []
+        for col, label in ((3, "istr_max"), (4, "axi_letture"), (5, "axi_scritture")):
+            if new[col] > old[name][col]:
+                fail.append("%s %d->%d" % (label, old[name][col], new[col]))
+        if fail:
+            print("%s: FAIL %s" % (name, " ".join(fail)))
+            status = 1
+        else:
+            print("%s: OK" % name)
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
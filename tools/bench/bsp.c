@@ -0,0 +1,130 @@
+// Pezzi del BSP che nel banco di prova (tools/bench) non vengono da
+// Vitis: interrupt della CPU, tabella dei timer, seriale e xil_printf.
+// La xil_printf scrive sulla UART Lite vera di QEMU (BENCH_CONSOLE), non
+// su quella finta dei programmi.
+
+#include <stdarg.h>
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xtmrctr_l.h"
+#include "xuartlite_l.h"
+#include "xil_printf.h"
+#include "mb_interface.h"
+#include "platform.h"
+#include "bench.h"
+
+u8 XTmrCtr_Offsets[] = { 0, XTC_TIMER_COUNTER_OFFSET };
+
+void microblaze_enable_interrupts(void)
+{
+    __asm__ volatile ("msrset r0, 0x2" ::: "memory");
+}
+
+void microblaze_disable_interrupts(void)
+{
+    __asm__ volatile ("msrclr r0, 0x2" ::: "memory");
+}
+
+void init_platform(void) { }
+void cleanup_platform(void) { }
+
+void XUartLite_SendByte(UINTPTR BaseAddress, u8 Data)
+{
+    while (XUartLite_GetStatusReg(BaseAddress) & XUL_SR_TX_FIFO_FULL)
+        ;
+    XUartLite_WriteReg(BaseAddress, XUL_TX_FIFO_OFFSET, Data);
+}
+
+u8 XUartLite_RecvByte(UINTPTR BaseAddress)
+{
+    while (!(XUartLite_GetStatusReg(BaseAddress) & XUL_SR_RX_FIFO_VALID_DATA))
+        ;
+    return (u8)XUartLite_ReadReg(BaseAddress, XUL_RX_FIFO_OFFSET);
+}
+
+// gcc le chiama da solo per copiare o azzerare le strutture: senza libc
+// servono qui
+void *memcpy(void *dst, const void *src, __SIZE_TYPE__ n)
+{
+    u8 *d = dst;
+    const u8 *s = src;
+
+    while (n--)
+        *d++ = *s++;
+    return dst;
+}
+
+void *memset(void *dst, int c, __SIZE_TYPE__ n)
+{
+    u8 *d = dst;
+
+    while (n--)
+        *d++ = (u8)c;
+    return dst;
+}
+
+// --- CONSOLE DEL BANCO ---
+void bench_putc(char c)
+{
+    XUartLite_SendByte(BENCH_CONSOLE, (u8)c);
+}
+
+static void put_str(const char *s)
+{
+    while (*s)
+        bench_putc(*s++);
+}
+
+static void put_num(u32 v, u32 base, int neg)
+{
+    char buf[12];
+    int n = 0;
+
+    if (neg)
+        bench_putc('-');
+    do {
+        buf[n++] = "0123456789abcdef"[v % base];
+        v /= base;
+    } while (v);
+    while (n)
+        bench_putc(buf[--n]);
+}
+
+void xil_printf(const char *fmt, ...)
+{
+    va_list ap;
+    s32 d;
+
+    va_start(ap, fmt);
+    for (; *fmt; fmt++) {
+        if (*fmt != '%') {
+            bench_putc(*fmt);
+            continue;
+        }
+        switch (*++fmt) {
+        case 'd':
+            d = va_arg(ap, s32);
+            put_num((d < 0) ? (u32)-d : (u32)d, 10, d < 0);
+            break;
+        case 'u':
+            put_num(va_arg(ap, u32), 10, 0);
+            break;
+        case 'x':
+            put_num(va_arg(ap, u32), 16, 0);
+            break;
+        case 'c':
+            bench_putc((char)va_arg(ap, int));
+            break;
+        case 's':
+            put_str(va_arg(ap, const char *));
+            break;
+        case '\0':
+            fmt--;
+            break;
+        default:
+            bench_putc(*fmt);
+            break;
+        }
+    }
+    va_end(ap);
+}
@@ -0,0 +1,17 @@
+#ifndef MB_INTERFACE_H
+#define MB_INTERFACE_H
+
+#include "xil_types.h"
+
+// Come mb_interface.h di Vitis: MSR letto e scritto in linea, abilitazione
+// degli interrupt come funzioni (bsp.c)
+void microblaze_enable_interrupts(void);
+void microblaze_disable_interrupts(void);
+
+#define mfmsr() \
+    ({ u32 _rval; __asm__ __volatile__ ("mfs\t%0,rmsr\n" : "=d"(_rval)); _rval; })
+
+#define mtmsr(v) \
+    __asm__ __volatile__ ("mts\trmsr,%0\n\tnop\n" :: "d"(v))
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// Nel banco non ci sono cache da accendere: funzioni vuote (bsp.c)
+void init_platform(void);
+void cleanup_platform(void);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef XIL_IO_H
+#define XIL_IO_H
+
+#include "xil_types.h"
+
+// Un accesso al bus per chiamata, come le versioni inline di Vitis
+static inline u32 Xil_In32(UINTPTR addr)
+{
+    return *(volatile u32 *)addr;
+}
+
+static inline void Xil_Out32(UINTPTR addr, u32 value)
+{
+    *(volatile u32 *)addr = value;
+}
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef XIL_PRINTF_H
+#define XIL_PRINTF_H
+
+#include "xil_types.h"
+
+// Versione ridotta (bsp.c): %d %u %x %c %s, senza larghezze
+void xil_printf(const char *fmt, ...);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef XIL_TYPES_H
+#define XIL_TYPES_H
+
+// Tipi del BSP per il banco di prova (tools/bench): stessi nomi e
+// larghezze di quelli di Vitis per il MicroBlaze a 32 bit
+
+typedef unsigned char       u8;
+typedef unsigned short      u16;
+typedef unsigned long       u32;
+typedef unsigned long long  u64;
+typedef signed char         s8;
+typedef short               s16;
+typedef long                s32;
+typedef long long           s64;
+typedef unsigned long       UINTPTR;
+
+#ifndef NULL
+#define NULL    ((void *)0)
+#endif
+
+#endif
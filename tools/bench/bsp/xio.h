@@ -0,0 +1,6 @@
+#ifndef XIO_H
+#define XIO_H
+
+#include "xil_io.h"
+
+#endif
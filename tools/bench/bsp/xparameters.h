@@ -0,0 +1,37 @@
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+// Periferiche del banco di prova (tools/bench). Tutte le periferiche AXI
+// stanno nelle due pagine da 16 MB a 0x40000000 e 0x41000000, come i
+// registri scritti a mano nei programmi (LED, pulsanti, INTC): crt0.S le
+// mappa su RAM, quindi ogni registro è una cella di memoria che il banco
+// prepara prima di ogni chiamata.
+
+#define XPAR_TMRCTR_0_BASEADDR          0x41C00000  // Timer dei programmi
+#define XPAR_TMRCTR_1_BASEADDR          0x41C10000  // Base dei tempi (cascata)
+#define XPAR_UARTLITE_0_BASEADDR        0x40600000
+#define XPAR_GPIO_MOTORS_BASEADDR       0x40010000
+#define XPAR_GPIO_5_BASEADDR            0x40020000
+
+#define XPAR_AXI_TIMER_0_INTERRUPT_MASK 0x1
+#define XPAR_BUTTON_IP2INTC_IRPT_MASK   0x2
+#define XPAR_GPIO_IP2INTC_IRPT_MASK     0x4
+
+#define XPAR_AXI_TIMER_0_CLOCK_FREQ_HZ  100000000
+#define XPAR_CPU_CORE_CLOCK_FREQ_HZ     100000000
+
+// Unità del MicroBlaze: bench.sh le ricava dalle opzioni del compilatore
+#ifndef XPAR_MICROBLAZE_USE_HW_MUL
+#define XPAR_MICROBLAZE_USE_HW_MUL      0
+#endif
+#ifndef XPAR_MICROBLAZE_USE_DIV
+#define XPAR_MICROBLAZE_USE_DIV         0
+#endif
+#ifndef XPAR_MICROBLAZE_USE_BARREL
+#define XPAR_MICROBLAZE_USE_BARREL      0
+#endif
+#ifndef XPAR_MICROBLAZE_USE_FPU
+#define XPAR_MICROBLAZE_USE_FPU         0
+#endif
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef XUARTLITE_L_H
+#define XUARTLITE_L_H
+
+#include "xil_io.h"
+
+// Registri dell'AXI UART Lite, come xuartlite_l.h di Vitis
+
+#define XUL_RX_FIFO_OFFSET          0
+#define XUL_TX_FIFO_OFFSET          4
+#define XUL_STATUS_REG_OFFSET       8
+#define XUL_CONTROL_REG_OFFSET      12
+
+#define XUL_SR_PARITY_ERROR         0x80
+#define XUL_SR_FRAMING_ERROR        0x40
+#define XUL_SR_OVERRUN_ERROR        0x20
+#define XUL_SR_INTR_ENABLED         0x10
+#define XUL_SR_TX_FIFO_FULL         0x08
+#define XUL_SR_TX_FIFO_EMPTY        0x04
+#define XUL_SR_RX_FIFO_FULL         0x02
+#define XUL_SR_RX_FIFO_VALID_DATA   0x01
+
+#define XUartLite_ReadReg(BaseAddress, RegOffset) \
+    Xil_In32((BaseAddress) + (RegOffset))
+
+#define XUartLite_WriteReg(BaseAddress, RegOffset, Data) \
+    Xil_Out32((BaseAddress) + (RegOffset), (u32)(Data))
+
+#define XUartLite_GetStatusReg(BaseAddress) \
+    XUartLite_ReadReg((BaseAddress), XUL_STATUS_REG_OFFSET)
+
+void XUartLite_SendByte(UINTPTR BaseAddress, u8 Data);
+u8   XUartLite_RecvByte(UINTPTR BaseAddress);
+
+#endif
@@ -0,0 +1,333 @@
+// Prova al banco della console a parole (console.h) senza scheda: righe
+// battute sulla seriale e, per ognuna, cosa arriva al gestore dei tasti e
+// quali comandi partono, nell'ordine.
+//
+// Le tabelle dei comandi sono quelle del rover e di rgb-uart, con i tasti
+// singoli dei due moduli; si controlla anche che nessun comando inizi con
+// un tasto (la prima lettera va sempre subito al gestore).
+//
+// Poi i tempi: ogni byte delle righe di prova e dei casi peggiori (parola
+// lunga CON_WORD_MAX, numeri saturati, tabella piena di 32 comandi con lo
+// stesso prefisso) si misura con la stessa con->prof del comando 'p' sulla
+// scheda, compilando con ISR_PROFILE e l'orologio del PC al posto della
+// base dei tempi. Per byte vale il minimo su TIME_REPEAT ripetizioni dallo
+// stesso stato (toglie interrupt e cache del PC), meno il costo della
+// lettura dell'orologio. I ns del PC diventano cicli a 100 MHz: è un
+// limite inferiore dei cicli del MicroBlaze, che in un ciclo fa meno del
+// PC in un ns. Oltre LOOP_BUDGET_CONSOLE_BYTE la prova fallisce (superarlo
+// qui vuol dire superarlo di sicuro sulla scheda); stare sotto non basta,
+// la misura vera resta 'p' sulla scheda.
+//
+// Compilato da tools/console_sim.sh con il cc del PC: non usa il BSP.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+// Tipi, base dei tempi, traccia e fasi di boot finti al posto di
+// xil_types.h e xil_printf.h (vuoti, dallo script), timebase.h, trace.h e
+// boot.h (saltati dalle guardie). La profilazione è quella vera.
+#define ISR_PROFILE
+#define XIL_TYPES_H
+#define TIMEBASE_H
+#define TRACE_H
+#define BOOT_H
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int32_t  s32;
+typedef uint64_t u64;
+
+#define TR_CMD  2
+static void trace_log(u8 type, u8 a, u16 b) { (void)type; (void)a; (void)b; }
+
+#define BOOT_PH_CMD 0
+static void boot_mark(int ph) { (void)ph; }
+
+// Base dei tempi: ns del PC (le differenze a 32 bit bastano per un byte)
+static u32 timebase_now32(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u32)((u64)ts.tv_sec * 1000000000U + (u64)ts.tv_nsec);
+}
+
+static char out[256];   // Tasti e comandi della riga in corso
+
+static int xil_printf(const char *fmt, ...)
+{
+    va_list ap;
+    size_t n = strlen(out);
+
+    va_start(ap, fmt);
+    vsnprintf(out + n, sizeof(out) - n, fmt, ap);
+    va_end(ap);
+    return 0;
+}
+
+#include "isr_prof.h"
+
+void isr_prof_reset(isr_prof_t *p) { memset(p, 0, sizeof(*p)); }
+int  isr_prof_report(const char *name, const isr_prof_t *p, u32 budget) { return 0; }
+
+#include "console.c"
+
+static void Key(u8 c) { xil_printf("%c", c); }
+
+static void Cmd(const char *name, const s32 *argv, u8 argc)
+{
+    u8 i;
+
+    xil_printf("[%s", name);
+    for (i = 0; i < argc; i++)
+        xil_printf(" %d", (int)argv[i]);
+    xil_printf("]");
+}
+
+static void CmdVel(const s32 *argv, u8 argc)  { Cmd("vel", argv, argc); }
+static void CmdRgb(const s32 *argv, u8 argc)  { Cmd("rgb", argv, argc); }
+static void CmdInfo(const s32 *argv, u8 argc) { Cmd("info", argv, argc); }
+static void CmdHz(const s32 *argv, u8 argc)   { Cmd("hz", argv, argc); }
+
+static const console_cmd_t rover_cmds[] = {
+    { "vel",  2, 2, CmdVel,  "vel R L" },
+    { "info", 0, 0, CmdInfo, "info" },
+    { "hz",   0, 2, CmdHz,   "hz [Hz [bit]]" },
+};
+static const console_cmd_t rgb_cmds[] = {
+    { "rgb",  3, 3, CmdRgb,  "rgb R G B" },
+    { "info", 0, 0, CmdInfo, "info" },
+    { "hz",   0, 2, CmdHz,   "hz [Hz [bit]]" },
+};
+
+typedef struct {
+    const char *in;     // Byte battuti
+    const char *want;   // Tasti al gestore e comandi eseguiti
+} sim_case_t;
+
+static const sim_case_t rover_cases[] = {
+    { "vel 120 -80\r",      "v[vel 120 -80]" },
+    { "info\n",             "i[info]" },
+    { "hz 20000 3\r",       "h[hz 20000 3]" },
+    { "hz\r",               "h[hz]" },
+    { "fsl",                "fsl" },            // Tasti singoli: subito
+    { "fvel 1 2\r",         "fv[vel 1 2]" },    // Tasto e poi parola, senza spazio
+    { "vx\r",               "vx" },             // Non è un comando
+    { "vxvel 3 4\r",        "vxv[vel 3 4]" },   // Dopo lo scarto, parola nuova
+    { "infx\r",             "infx" },
+    { "infxinfo\r",         "infxi[info]" },
+    { "ve\r",               "ve" },             // Fine riga a metà parola
+    { "vel 1\r",            "vUso: vel R L\r\n" },
+    { "vel 1 x 2\r",        "vUso: vel R L\r\n" },
+    { "w3",                 "w3" },
+    { "  vel  5  6 \r\n",   "v[vel 5 6]" },
+};
+
+static const sim_case_t rgb_cases[] = {
+    { "rgb 255 128 0\r",    "r[rgb 255 128 0]" },
+    { "1rgb 0 0 255\r",     "1r[rgb 0 0 255]" },
+    { "12rgb 1 2 3\r",      "12r[rgb 1 2 3]" },
+    { "1 rgb 4 5 6\r",      "1r[rgb 4 5 6]" },
+    { "rx\r",               "rx" },
+    { "rxrgb 7 8 9\r",      "rxr[rgb 7 8 9]" },
+    { "rg5rgb 1 1 1\r",     "rg5r[rgb 1 1 1]" },
+    { "info\r",             "i[info]" },
+    { "hz 976\r",           "h[hz 976]" },
+    { "p",                  "p" },
+};
+
+// Nessun comando deve iniziare con un tasto del modulo
+static int check_keys(const char *mod, const console_cmd_t *cmds, u8 n, const char *keys)
+{
+    int fails = 0;
+    u8 i;
+
+    for (i = 0; i < n; i++)
+        if (strchr(keys, cmds[i].name[0])) {
+            printf("%-6s comando \"%s\" inizia con un tasto  FAIL\n", mod, cmds[i].name);
+            fails++;
+        }
+    return fails;
+}
+
+// Stampa una riga con CR e LF visibili
+static void print_esc(const char *s, int width)
+{
+    int n = 0;
+
+    for (; *s; s++, n++) {
+        if (*s == '\r' || *s == '\n') {
+            printf("\\%c", (*s == '\r') ? 'r' : 'n');
+            n++;
+        } else {
+            putchar(*s);
+        }
+    }
+    while (n++ < width)
+        putchar(' ');
+}
+
+static int run(const char *mod, const console_cmd_t *cmds, u8 n_cmds,
+               const sim_case_t *cases, int n_cases)
+{
+    console_t con;
+    const char *p;
+    int i, ok, fails = 0;
+
+    console_init(&con, cmds, n_cmds, Key);
+    for (i = 0; i < n_cases; i++) {
+        out[0] = '\0';
+        for (p = cases[i].in; *p; p++)
+            console_feed(&con, (u8)*p);
+        console_feed(&con, '\r');   // Ogni caso parte da una riga nuova
+        ok = (strcmp(out, cases[i].want) == 0);
+        fails += !ok;
+        printf("%-6s ", mod);
+        print_esc(cases[i].in, 20);
+        printf(" -> ");
+        print_esc(out, 24);
+        printf(" %s\n", ok ? "OK" : "FAIL");
+        if (!ok) {
+            printf("       atteso ");
+            print_esc(cases[i].want, 0);
+            printf("\n");
+        }
+    }
+    return fails;
+}
+
+// --- TEMPI PER BYTE ---
+#define TIME_REPEAT     2000
+#define NS_PER_CYCLE    10      // 100 MHz
+
+static u32 clock_ns;            // Costo di ISR_PROF_BEGIN/END a vuoto
+
+static u32 max_u32(u32 a, u32 b) { return (a > b) ? a : b; }
+
+static void CmdNop(const s32 *argv, u8 argc) { (void)argv; (void)argc; }
+static void KeyNop(u8 c) { (void)c; }
+
+// Tabella piena: 32 comandi "zzz?" che restano tutti candidati fino alla
+// quarta lettera, così ogni byte fa il giro completo della tabella
+static char full_names[32][CON_WORD_MAX + 1];
+static console_cmd_t full_cmds[32];
+
+static void full_init(void)
+{
+    static const char last[] = "abcdefghijklmnopqrstuvwxyz012345";
+    int i;
+
+    for (i = 0; i < 32; i++) {
+        memcpy(full_names[i], "zzz", 3);
+        full_names[i][3] = last[i];
+        full_cmds[i].name = full_names[i];
+        full_cmds[i].min_args = 0;
+        full_cmds[i].max_args = CON_MAX_ARGS;
+        full_cmds[i].fn = CmdNop;
+        full_cmds[i].usage = "zzz? [n...]";
+    }
+}
+
+typedef struct {
+    const char *mod;
+    const console_cmd_t *cmds;
+    u8 n_cmds;
+    const char *in;
+} time_case_t;
+
+static const time_case_t worst_cases[] = {
+    { "rover", rover_cmds, 3, "info" },                         // Parola lunga CON_WORD_MAX
+    { "rover", rover_cmds, 3, "infox" },                        // Oltre CON_WORD_MAX: scarto
+    { "rover", rover_cmds, 3, "vel 999999999 -999999999" },     // Numeri saturati
+    { "rover", rover_cmds, 3, "vel 1 2 3 4 5 6" },              // Troppi argomenti
+    { "rgb",   rgb_cmds,  3, "rgb 99999999 99999999 99999999" },
+    { "piena", full_cmds, 32, "zzz5 99999999 -99999999 99999999 99999999" },
+    { "piena", full_cmds, 32, "zzz9" },                         // Scarto alla quarta lettera
+    { "piena", full_cmds, 32, "zzzzzzzz" },
+};
+
+// ns del PC per l'analisi di un byte, dallo stato in cui si trova la console
+static u32 time_byte(console_t *con, u8 c)
+{
+    console_t snap = *con;
+    u32 r, best = 0xFFFFFFFF;
+
+    for (r = 0; r < TIME_REPEAT; r++) {
+        *con = snap;
+        out[0] = '\0';
+        console_feed(con, c);
+        if (con->prof.last < best)
+            best = con->prof.last;
+    }
+    return (best > clock_ns) ? best - clock_ns : 0;
+}
+
+// Una riga più il CR finale: stampa media e massimo per byte, restituisce il massimo
+static u32 time_line(const char *mod, const console_cmd_t *cmds, u8 n_cmds, const char *in)
+{
+    console_t con;
+    const char *p = in;
+    u32 ns, worst = 0, total = 0, n = 0;
+
+    console_init(&con, cmds, n_cmds, KeyNop);
+    do {
+        ns = time_byte(&con, *p ? (u8)*p : '\r');
+        total += ns;
+        n++;
+        worst = max_u32(worst, ns);
+    } while (*p++);
+
+    printf("%-6s ", mod);
+    print_esc(in, 44);
+    printf(" %3u byte  ns media %3u  max %3u\n", (unsigned)n, (unsigned)(total / n), (unsigned)worst);
+    return worst;
+}
+
+static int run_time(void)
+{
+    isr_prof_t p = ISR_PROF_INIT;
+    u32 r, worst = 0;
+    int i;
+
+    // Costo della misura stessa, da togliere a ogni byte
+    clock_ns = 0xFFFFFFFF;
+    for (r = 0; r < TIME_REPEAT; r++) {
+        ISR_PROF_BEGIN(t);
+        ISR_PROF_END(p, t);
+        if (p.last < clock_ns)
+            clock_ns = p.last;
+    }
+
+    full_init();
+    printf("Tempo per byte sul PC (comandi esclusi)\n");
+    for (i = 0; i < (int)(sizeof(rover_cases) / sizeof(rover_cases[0])); i++)
+        worst = max_u32(worst, time_line("rover", rover_cmds, 3, rover_cases[i].in));
+    for (i = 0; i < (int)(sizeof(rgb_cases) / sizeof(rgb_cases[0])); i++)
+        worst = max_u32(worst, time_line("rgb", rgb_cmds, 3, rgb_cases[i].in));
+    for (i = 0; i < (int)(sizeof(worst_cases) / sizeof(worst_cases[0])); i++)
+        worst = max_u32(worst, time_line(worst_cases[i].mod, worst_cases[i].cmds,
+                                         worst_cases[i].n_cmds, worst_cases[i].in));
+
+    // In cicli a 100 MHz, per eccesso
+    worst = (worst + NS_PER_CYCLE - 1) / NS_PER_CYCLE;
+    printf("Caso peggiore %u cicli per byte (limite inferiore), budget %u: %s\n",
+           (unsigned)worst, (unsigned)LOOP_BUDGET_CONSOLE_BYTE,
+           (worst > LOOP_BUDGET_CONSOLE_BYTE) ? "FAIL" : "OK");
+    return worst > LOOP_BUDGET_CONSOLE_BYTE;
+}
+
+int main(void)
+{
+    int fails = 0;
+
+    fails += check_keys("rover", rover_cmds, 3, "fbslrqezcdpmwW");
+    fails += check_keys("rgb", rgb_cmds, 3, "0123456789pmwW");
+    fails += run("rover", rover_cmds, 3, rover_cases, sizeof(rover_cases) / sizeof(rover_cases[0]));
+    fails += run("rgb", rgb_cmds, 3, rgb_cases, sizeof(rgb_cases) / sizeof(rgb_cases[0]));
+
+    printf(fails ? "%d casi FAIL\n" : "Tutti i casi OK\n", fails);
+    fails += run_time();
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Prova al banco della console a parole (tools/console_sim.c).
+# Compila console.c con il cc del PC, senza BSP, ed esegue i casi:
+# uscita 1 se una riga non dà i tasti e i comandi attesi o se un byte
+# costa più di LOOP_BUDGET_CONSOLE_BYTE (isr_budget.h).
+#
+# Uso:
+#   tools/console_sim.sh
+#
+# Variabili: HOST_CC (default cc).
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT="${OUT:-$ROOT/_sim_build}"
+HOST_CC="${HOST_CC:-cc}"
+
+# xil_types.h e xil_printf.h vuoti: li sostituisce la prova
+mkdir -p "$OUT/inc"
+: > "$OUT/inc/xil_types.h"
+: > "$OUT/inc/xil_printf.h"
+$HOST_CC -std=gnu99 -O2 -Wall -I"$ROOT" -I"$OUT/inc" "$ROOT/tools/console_sim.c" -o "$OUT/console_sim"
+"$OUT/console_sim"
@@ -0,0 +1,357 @@
+// Prova al banco di fixmath (fixmath.h) senza scheda: ogni operazione
+// contro un riferimento a 64 bit con la stessa semantica (modulo troncato,
+// segno applicato dopo, saturazione al campo), bit per bit.
+//
+// Ingressi: tutte le coppie dei valori di bordo (zero, uno, MIN, MAX,
+// mezze parole piene, ...) più coppie pseudo-casuali ripetibili di ogni
+// ordine di grandezza; fix_scale8, fix_lerp8 e fix_sin su tutti gli
+// ingressi possibili. Il seno si confronta con sin() entro FIX_SIN_ERR_MAX.
+//
+// Compilato da tools/fix_sim.sh una volta per variante (FIX_HW_* forzati,
+// come tools/fix_variants.sh) con il cc del PC: non usa il BSP. I tempi
+// sono nanosecondi del PC per chiamata e servono solo a confrontare le
+// varianti tra loro; i cicli del MicroBlaze si misurano sulla scheda con
+// "@x" (fixmath_bench).
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+// Tipi, timebase e stampa finti al posto di xil_types.h, xstatus.h e
+// xil_printf.h (vuoti, dallo script) e di timebase.h (saltato dalla guardia)
+#define XIL_TYPES_H
+#define TIMEBASE_H
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int16_t  s16;
+typedef int32_t  s32;
+typedef int64_t  s64;
+
+#define XST_SUCCESS     0
+#define XST_FAILURE     1
+#define xil_printf      printf
+static u32 timebase_now32(void) { return 0; }
+
+#include "fixmath.c"    // Tabelle del seno e della gamma
+
+#ifndef FIX_VARIANT
+#define FIX_VARIANT     "?"
+#endif
+
+#define FIX_SIN_ERR_MAX 4       // LSB Q1.15: tabella arrotondata + interpolazione
+#define N_RAND          200000  // Coppie casuali per operazione
+#define N_TIME          4096    // Ingressi per la misura dei tempi
+#define N_REPEAT        200
+
+static int failed;
+
+// --- RIFERIMENTI A 64 BIT ---
+static s64 sat(s64 x, s64 lo, s64 hi) { return x < lo ? lo : x > hi ? hi : x; }
+static s64 mag(s64 x) { return x < 0 ? -x : x; }
+
+static q8_8_t ref_q8_mul(q8_8_t a, q8_8_t b)
+{
+    s64 m = (mag(a) * mag(b)) >> 8;
+    return (q8_8_t)sat(((a ^ b) < 0) ? -m : m, FIX_Q8_MIN, FIX_Q8_MAX);
+}
+
+static q16_16_t ref_q16_add(q16_16_t a, q16_16_t b)
+{
+    return (q16_16_t)sat((s64)a + b, FIX_Q16_MIN, FIX_Q16_MAX);
+}
+
+static q16_16_t ref_q16_sub(q16_16_t a, q16_16_t b)
+{
+    return (q16_16_t)sat((s64)a - b, FIX_Q16_MIN, FIX_Q16_MAX);
+}
+
+static q16_16_t ref_q16_mul(q16_16_t a, q16_16_t b)
+{
+    s64 m = (s64)(((u64)mag(a) * (u64)mag(b)) >> 16);
+    return (q16_16_t)sat(((a ^ b) < 0) ? -m : m, FIX_Q16_MIN, FIX_Q16_MAX);
+}
+
+static q16_16_t ref_q16_div(q16_16_t a, q16_16_t b)
+{
+    s64 m;
+    if (b == 0)
+        return (a < 0) ? FIX_Q16_MIN : FIX_Q16_MAX;
+    m = (s64)(((u64)mag(a) << 16) / (u64)mag(b));
+    return (q16_16_t)sat(((a ^ b) < 0) ? -m : m, FIX_Q16_MIN, FIX_Q16_MAX);
+}
+
+static q16_16_t ref_q16_recip(q16_16_t x) { return ref_q16_div(FIX_Q16_ONE, x); }
+
+static u32 ref_udiv32(u32 n, u32 d) { return d ? n / d : 0xFFFFFFFF; }
+
+static u8 ref_scale8(u8 v, q8_8_t k)
+{
+    s64 p = k <= 0 ? 0 : ((s64)v * k + 0x80) >> 8;
+    return (u8)sat(p, 0, 255);
+}
+
+static u8 ref_lerp8(u8 a, u8 b, u16 t)
+{
+    if (t >= 256) return b;
+    // Verso a: il passo si tronca in modulo, come nella versione fissa
+    return (u8)(b >= a ? a + (((s64)(b - a) * t) >> 8) : a - (((s64)(a - b) * t) >> 8));
+}
+
+// --- INGRESSI ---
+static const s32 edge32[] = {
+    0, 1, -1, 2, -2, 0x7FFF, 0x8000, 0xFFFF, -0xFFFF, 0x10000, -0x10000,
+    0x10001, 0x1FFFF, 0xFFFFFF, -0x1000000, 0x12345678, -0x12345678,
+    0x40000000, -0x40000000, 0x7FFFFFFF, -0x7FFFFFFF, (s32)0x80000000,
+};
+#define N_EDGE32    (sizeof(edge32) / sizeof(edge32[0]))
+
+static const s16 edge16[] = {
+    0, 1, -1, 0x7F, 0x80, 0xFF, 0x100, -0x100, 0x101, 0x1000, -0x1000,
+    0x7FFF, -0x7FFF, (s16)0x8000,
+};
+#define N_EDGE16    (sizeof(edge16) / sizeof(edge16[0]))
+
+static u32 seed = 12345;
+
+// Valore casuale di ordine di grandezza casuale, segno compreso
+static s32 rnd32(void)
+{
+    u32 v, sh;
+    seed = seed * 1664525U + 1013904223U;
+    v = seed;
+    seed = seed * 1664525U + 1013904223U;
+    sh = seed >> 27;
+    v >>= sh;
+    return (seed & 0x00010000U) ? (s32)(0U - v) : (s32)v;
+}
+
+// --- CONFRONTI ---
+static void result(const char *op, u32 cases, u32 bad)
+{
+    printf("%-10s %9u casi  %s\n", op, (unsigned)cases, bad ? "FAIL" : "OK");
+    if (bad) failed = 1;
+}
+
+#define CHECK2(op, fn, ref, type, a, b, bad) do { \
+        type g_ = fn(a, b), r_ = ref(a, b); \
+        if (g_ != r_) { \
+            if ((bad)++ < 3) \
+                printf("  %s(%ld, %ld) = %ld, atteso %ld\n", op, \
+                       (long)(a), (long)(b), (long)g_, (long)r_); \
+        } \
+    } while (0)
+
+static void check_q16(const char *op, q16_16_t (*fn)(q16_16_t, q16_16_t),
+                      q16_16_t (*ref)(q16_16_t, q16_16_t))
+{
+    u32 i, j, bad = 0, cases = 0;
+
+    for (i = 0; i < N_EDGE32; i++)
+        for (j = 0; j < N_EDGE32; j++, cases++)
+            CHECK2(op, fn, ref, q16_16_t, edge32[i], edge32[j], bad);
+    for (i = 0; i < N_RAND; i++, cases++) {
+        s32 a = rnd32(), b = rnd32();
+        CHECK2(op, fn, ref, q16_16_t, a, b, bad);
+    }
+    result(op, cases, bad);
+}
+
+static q16_16_t do_q16_add(q16_16_t a, q16_16_t b) { return q16_add(a, b); }
+static q16_16_t do_q16_sub(q16_16_t a, q16_16_t b) { return q16_sub(a, b); }
+static q16_16_t do_q16_mul(q16_16_t a, q16_16_t b) { return q16_mul(a, b); }
+static q16_16_t do_q16_div(q16_16_t a, q16_16_t b) { return q16_div(a, b); }
+
+static void check_recip(void)
+{
+    u32 i, bad = 0, cases = 0;
+
+    for (i = 0; i < N_EDGE32 + N_RAND; i++, cases++) {
+        s32 x = (i < N_EDGE32) ? edge32[i] : rnd32();
+        q16_16_t g = q16_recip(x), r = ref_q16_recip(x);
+        if (g != r && bad++ < 3)
+            printf("  q16_recip(%ld) = %ld, atteso %ld\n", (long)x, (long)g, (long)r);
+    }
+    result("q16_recip", cases, bad);
+}
+
+static void check_q8_mul(void)
+{
+    u32 i, j, bad = 0, cases = 0;
+
+    for (i = 0; i < N_EDGE16; i++)
+        for (j = 0; j < N_EDGE16; j++, cases++)
+            CHECK2("q8_mul", q8_mul, ref_q8_mul, q8_8_t, edge16[i], edge16[j], bad);
+    for (i = 0; i < N_RAND; i++, cases++) {
+        q8_8_t a = (q8_8_t)rnd32(), b = (q8_8_t)rnd32();
+        CHECK2("q8_mul", q8_mul, ref_q8_mul, q8_8_t, a, b, bad);
+    }
+    result("q8_mul", cases, bad);
+}
+
+static void check_udiv(void)
+{
+    u32 i, j, bad = 0, cases = 0, rem;
+
+    for (i = 0; i < N_EDGE32 * N_EDGE32 + N_RAND; i++, cases++) {
+        u32 n = (i < N_EDGE32 * N_EDGE32) ? (u32)edge32[i / N_EDGE32] : (u32)rnd32();
+        u32 d = (i < N_EDGE32 * N_EDGE32) ? (u32)edge32[i % N_EDGE32] : (u32)rnd32();
+        u32 q = fix_udiv32(n, d);
+
+        j = (q != ref_udiv32(n, d));
+        if (d && !j)
+            j = (fix_udivmod32(n, d, &rem) != n / d || rem != n % d);
+        if (j && bad++ < 3)
+            printf("  fix_udiv32(%lu, %lu) = %lu, atteso %lu\n", (unsigned long)n,
+                   (unsigned long)d, (unsigned long)q, (unsigned long)ref_udiv32(n, d));
+    }
+    result("udiv32", cases, bad);
+}
+
+static void check_scale8(void)
+{
+    u32 v, k, bad = 0, cases = 0;
+
+    for (v = 0; v < 256; v++)
+        for (k = 0; k < 0x10000; k++, cases++)
+            CHECK2("scale8", fix_scale8, ref_scale8, u8, (u8)v, (q8_8_t)k, bad);
+    result("scale8", cases, bad);
+}
+
+static void check_lerp8(void)
+{
+    u32 a, b, t, bad = 0, cases = 0;
+
+    for (a = 0; a < 256; a++)
+        for (b = 0; b < 256; b++)
+            for (t = 0; t <= 257; t++, cases++) {
+                u8 g = fix_lerp8((u8)a, (u8)b, (u16)t), r = ref_lerp8((u8)a, (u8)b, (u16)t);
+                if (g != r && bad++ < 3)
+                    printf("  fix_lerp8(%u, %u, %u) = %u, atteso %u\n",
+                           (unsigned)a, (unsigned)b, (unsigned)t, (unsigned)g, (unsigned)r);
+            }
+    result("lerp8", cases, bad);
+}
+
+static void check_sin(void)
+{
+    u32 a, bad = 0;
+    int worst = 0;
+
+    for (a = 0; a < 0x10000; a++) {
+        int r = (int)lround(sin(a * (2.0 * M_PI / 65536.0)) * 32767.0);
+        int d = abs(fix_sin((u16)a) - r);
+        if (d > worst) worst = d;
+        if (fix_cos((u16)a) != fix_sin((u16)(a + 0x4000)))
+            bad++;
+    }
+    if (worst > FIX_SIN_ERR_MAX) bad++;
+    printf("%-10s %9u casi  errore max %d LSB (max %d)  %s\n", "sin", 0x10000U,
+           worst, FIX_SIN_ERR_MAX, bad ? "FAIL" : "OK");
+    if (bad) failed = 1;
+}
+
+#if FIX_HW_FPU
+static void check_float(void)
+{
+    u32 i, bad = 0;
+
+    // Sotto 2^24 il float è esatto: andata e ritorno senza perdite
+    for (i = 0; i < N_RAND; i++) {
+        s32 x = rnd32() >> 8;
+        if (q16_from_float(q16_to_float(x)) != x || q16_to_float(x) != x / 65536.0f)
+            bad++;
+    }
+    result("float", N_RAND, bad);
+}
+#endif
+
+// --- TEMPI ---
+static q16_16_t ta[N_TIME], tb[N_TIME];
+static volatile s32 sink;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Media per chiamata su N_TIME x N_REPEAT chiamate, loop compreso
+#define TIME(expr, ns) do { \
+        double t0_ = now_ns(); \
+        u32 r_, i; \
+        for (r_ = 0; r_ < N_REPEAT; r_++) \
+            for (i = 0; i < N_TIME; i++) \
+                sink = (expr); \
+        (ns) = (now_ns() - t0_) / ((double)N_TIME * N_REPEAT); \
+    } while (0)
+
+#define TIME_LINE(name, expr, ref) do { \
+        double f_, c_; \
+        TIME(expr, f_); \
+        TIME(ref, c_); \
+        printf("%-10s %8.2f %8.2f\n", name, f_, c_); \
+    } while (0)
+
+static void timing(void)
+{
+    u32 i;
+
+    // Come fixmath_bench: a in +-256.0, b in +-[1.0, 256.0]
+    seed = 12345;
+    for (i = 0; i < N_TIME; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        ta[i] = (q16_16_t)(seed >> 7) - (q16_16_t)0x01000000;
+        seed = seed * 1664525U + 1013904223U;
+        tb[i] = (q16_16_t)((seed >> 8) | FIX_Q16_ONE);
+        if (seed & 0x80000000U) tb[i] = -tb[i];
+    }
+
+    printf("op         ns fix   ns s64 (tempo del PC per chiamata)\n");
+    TIME_LINE("q8_mul", q8_mul((q8_8_t)(ta[i] >> 12), (q8_8_t)(tb[i] >> 12)),
+              ref_q8_mul((q8_8_t)(ta[i] >> 12), (q8_8_t)(tb[i] >> 12)));
+    TIME_LINE("q16_add", q16_add(ta[i], tb[i]), ref_q16_add(ta[i], tb[i]));
+    TIME_LINE("q16_mul", q16_mul(ta[i], tb[i] >> 8), ref_q16_mul(ta[i], tb[i] >> 8));
+    TIME_LINE("q16_div", q16_div(ta[i], tb[i]), ref_q16_div(ta[i], tb[i]));
+    TIME_LINE("q16_recip", q16_recip(tb[i]), ref_q16_recip(tb[i]));
+    TIME_LINE("udiv32", fix_udiv32((u32)ta[i], (u32)tb[i] >> 8),
+              ref_udiv32((u32)ta[i], (u32)tb[i] >> 8));
+    TIME_LINE("scale8", fix_scale8((u8)ta[i], (q8_8_t)(tb[i] >> 16)),
+              ref_scale8((u8)ta[i], (q8_8_t)(tb[i] >> 16)));
+    TIME_LINE("lerp8", fix_lerp8((u8)ta[i], (u8)tb[i], (u16)(ta[i] >> 23)),
+              ref_lerp8((u8)ta[i], (u8)tb[i], (u16)(ta[i] >> 23)));
+    TIME_LINE("sin", fix_sin((u16)ta[i]),
+              (s32)(sin((u16)ta[i] * (2.0 * M_PI / 65536.0)) * 32767.0));
+}
+
+int main(void)
+{
+    printf("=== %s (MUL=%d DIV=%d BARREL=%d FPU=%d)\n", FIX_VARIANT,
+           FIX_HW_MUL, FIX_HW_DIV, FIX_HW_BARREL, FIX_HW_FPU);
+
+    check_q8_mul();
+    check_q16("q16_add", do_q16_add, ref_q16_add);
+    check_q16("q16_sub", do_q16_sub, ref_q16_sub);
+    check_q16("q16_mul", do_q16_mul, ref_q16_mul);
+    check_q16("q16_div", do_q16_div, ref_q16_div);
+    check_recip();
+    check_udiv();
+    check_scale8();
+    check_lerp8();
+    check_sin();
+#if FIX_HW_FPU
+    check_float();
+#endif
+    timing();
+
+    if (failed) {
+        printf("%s: FAIL\n", FIX_VARIANT);
+        return 1;
+    }
+    return 0;
+}
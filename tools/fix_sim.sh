@@ -0,0 +1,49 @@
+#!/bin/sh
+# Prova al banco di fixmath per tutte le varianti (tools/fix_sim.c).
+# Compila la prova con il cc del PC, senza BSP, una volta per variante
+# con i FIX_HW_* forzati (le stesse di tools/fix_variants.sh), e per
+# ognuna confronta le operazioni con il riferimento a 64 bit e stampa i
+# tempi per chiamata: uscita 1 se una variante sbaglia anche un solo bit.
+# I tempi sono del PC: confrontano le varianti tra loro, i cicli del
+# MicroBlaze restano quelli di "@x" sulla scheda.
+#
+# Uso:
+#   tools/fix_sim.sh
+#
+# Variabili: HOST_CC (default cc).
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT="${OUT:-$ROOT/_sim_build}"
+HOST_CC="${HOST_CC:-cc}"
+
+# nome|MUL DIV BARREL FPU
+VARIANTS="
+minimo|0 0 0 0
+mul|1 0 0 0
+mul+barrel|1 0 1 0
+mul64+div+barrel|2 1 1 0
+completo|2 1 1 1
+"
+
+# xil_types.h, xparameters.h, xstatus.h e xil_printf.h vuoti: li
+# sostituisce la prova, e i FIX_HW_* arrivano dalla riga di comando
+mkdir -p "$OUT/inc"
+for h in xil_types.h xparameters.h xstatus.h xil_printf.h; do
+    : > "$OUT/inc/$h"
+done
+rm -f "$OUT/fix_failed"
+
+echo "$VARIANTS" | while IFS='|' read -r name hw; do
+    [ -n "$name" ] || continue
+    set -- $hw
+    exe="$OUT/fix_sim_$(echo "$name" | tr '+' '_')"
+    $HOST_CC -std=gnu99 -O2 -Wall -I"$ROOT" -I"$OUT/inc" \
+        -DFIX_VARIANT="\"$name\"" -DFIX_HW_MUL=$1 -DFIX_HW_DIV=$2 -DFIX_HW_BARREL=$3 -DFIX_HW_FPU=$4 \
+        "$ROOT/tools/fix_sim.c" -o "$exe" -lm
+    "$exe" || echo "$name" >> "$OUT/fix_failed"
+done
+
+[ -f "$OUT/fix_failed" ] && exit 1
+exit 0
@@ -0,0 +1,75 @@
+#!/bin/sh
+# Confronto delle varianti di fixmath per le configurazioni del MicroBlaze.
+#
+# Compila le operazioni di fixmath.h (una funzione ciascuna) una volta per
+# variante, con le opzioni del compilatore che corrispondono alle unità
+# presenti e i FIX_HW_* forzati, poi stampa per ognuna:
+#   - i byte di codice di ogni operazione (mb-nm)
+#   - le routine di libgcc ancora chiamate (__mulsi3, __divsi3, __muldi3, ...)
+# Nessuna variante deve chiamare libgcc (uscita 1).
+# I cicli si misurano sulla scheda con il comando "@x" del nucleo,
+# ricompilando l'immagine per il MicroBlaze da provare; i risultati di
+# ogni variante li confronta con il riferimento a 64 bit tools/fix_sim.sh.
+#
+# Uso:
+#   BSP_INCLUDE=<bsp>/include tools/fix_variants.sh
+#
+# Variabili: MB_PREFIX (default mb-), CFLAGS (default dalle opzioni di Vitis),
+#            BSP_INCLUDE (cartella include del BSP, obbligatoria).
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT="${OUT:-$ROOT/_fix_build}"
+CC="${MB_PREFIX-mb-}gcc"
+NM="${MB_PREFIX-mb-}nm"
+CFLAGS="${CFLAGS:--O2 -mlittle-endian -mcpu=v11.0}"
+
+if [ -z "$BSP_INCLUDE" ]; then
+    echo "BSP_INCLUDE non impostata (cartella include del BSP)" >&2
+    exit 2
+fi
+
+# nome|opzioni del compilatore|MUL DIV BARREL FPU
+VARIANTS="
+minimo|-mxl-soft-mul -mxl-soft-div -mno-xl-barrel-shift|0 0 0 0
+mul|-mno-xl-soft-mul -mxl-soft-div -mno-xl-barrel-shift|1 0 0 0
+mul+barrel|-mno-xl-soft-mul -mxl-soft-div -mxl-barrel-shift|1 0 1 0
+mul64+div+barrel|-mno-xl-soft-mul -mxl-multiply-high -mno-xl-soft-div -mxl-barrel-shift|2 1 1 0
+completo|-mno-xl-soft-mul -mxl-multiply-high -mno-xl-soft-div -mxl-barrel-shift -mhard-float|2 1 1 1
+"
+
+rm -rf "$OUT"
+mkdir -p "$OUT"
+
+# Un'istanza per operazione: le inline diventano simboli misurabili
+cat > "$OUT/fix_ops.c" <<'END'
+#include "fixmath.h"
+q8_8_t   op_q8_mul(q8_8_t a, q8_8_t b)      { return q8_mul(a, b); }
+q16_16_t op_q16_add(q16_16_t a, q16_16_t b) { return q16_add(a, b); }
+q16_16_t op_q16_mul(q16_16_t a, q16_16_t b) { return q16_mul(a, b); }
+q16_16_t op_q16_div(q16_16_t a, q16_16_t b) { return q16_div(a, b); }
+q16_16_t op_q16_recip(q16_16_t x)           { return q16_recip(x); }
+u8       op_scale8(u8 v, q8_8_t k)          { return fix_scale8(v, k); }
+u8       op_lerp8(u8 a, u8 b, u16 t)        { return fix_lerp8(a, b, t); }
+s16      op_sin(u16 a)                      { return fix_sin(a); }
+END
+
+echo "$VARIANTS" | while IFS='|' read -r name flags hw; do
+    [ -n "$name" ] || continue
+    set -- $hw
+    obj="$OUT/fix_ops_$(echo "$name" | tr '+' '_').o"
+    $CC $CFLAGS $flags -DFIX_HW_MUL=$1 -DFIX_HW_DIV=$2 -DFIX_HW_BARREL=$3 -DFIX_HW_FPU=$4 \
+        -I"$ROOT" -I"$BSP_INCLUDE" -c "$OUT/fix_ops.c" -o "$obj"
+
+    echo "=== $name (MUL=$1 DIV=$2 BARREL=$3 FPU=$4)"
+    $NM -S "$obj" | grep ' op_' | while read -r addr size type sym; do
+        echo "$sym $((0x$size))"
+    done
+    calls=$($NM -u "$obj" | grep ' __' | sed 's/.* //' | tr '\n' ' ')
+    echo "libgcc: ${calls:-nessuna}"
+    [ -z "$calls" ] || echo fail >> "$OUT/failed"
+done
+
+[ -f "$OUT/failed" ] && exit 1
+exit 0
@@ -0,0 +1,136 @@
+// Prova al banco dei registri ombra (gpio_shadow.h) senza scheda: conta le
+// letture e le scritture sul bus dei LED e di IER, prima e dopo l'ombra.
+//
+// "Prima" è il codice dei programmi com'era (righe riportate nei commenti),
+// con ogni accesso al registro contato; "dopo" sono le chiamate di oggi a
+// gpio_shadow.h, con GPIO_SH_BUS_WRITE ridefinito per contare. Le due
+// versioni girano sulla stessa sequenza e alla fine di ogni passo il
+// registro deve avere lo stesso valore. Uscita 1 se l'ombra legge il bus,
+// scrive più del codice vecchio o lascia un valore diverso.
+//
+// Compilato da tools/gpio_shadow_sim.sh con il cc del PC: non usa il BSP.
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Tipi e interrupt finti al posto di xil_types.h e mb_interface.h (vuoti,
+// dallo script)
+typedef uint32_t u32;
+
+#define mfmsr()                         0
+#define mtmsr(msr)                      ((void)(msr))
+#define microblaze_disable_interrupts() ((void)0)
+
+typedef struct {
+    u32 reads, writes;
+} bus_t;
+
+static bus_t bus_old, bus_new;
+
+static u32 bus_rd(bus_t *b, volatile u32 *reg)
+{
+    b->reads++;
+    return *reg;
+}
+
+static void bus_wr(bus_t *b, volatile u32 *reg, u32 v)
+{
+    b->writes++;
+    *reg = v;
+}
+
+#define GPIO_SH_BUS_WRITE(sh, v)    bus_wr(&bus_new, (sh)->reg, (v))
+
+#include "gpio_shadow.h"
+
+// Accessi del codice vecchio
+#define OLD_RD(p)       bus_rd(&bus_old, (p))
+#define OLD_WR(p, v)    bus_wr(&bus_old, (p), (v))
+
+static volatile u32 reg_old, reg_new;
+static gpio_shadow_t sh = GPIO_SHADOW_INIT(&reg_new);
+
+#define STEPS   1000
+
+static int fails;
+
+static void reset(void)
+{
+    bus_old.reads = bus_old.writes = 0;
+    bus_new.reads = bus_new.writes = 0;
+    reg_old = reg_new = 0;
+    sh.value = 0;
+}
+
+static void same(const char *name, int step)
+{
+    if (reg_old != reg_new && fails++ < 10)
+        printf("%-28s passo %d: 0x%08x invece di 0x%08x  FAIL\n",
+               name, step, (unsigned)reg_new, (unsigned)reg_old);
+}
+
+static void report(const char *name)
+{
+    int ok = (bus_new.reads == 0 && bus_new.writes <= bus_old.writes);
+
+    printf("%-28s prima %5u L %5u S   dopo %5u L %5u S  %s\n", name,
+           (unsigned)bus_old.reads, (unsigned)bus_old.writes,
+           (unsigned)bus_new.reads, (unsigned)bus_new.writes, ok ? "OK" : "FAIL");
+    fails += !ok;
+}
+
+int main(void)
+{
+    u32 i, mask;
+
+    printf("%d passi per scenario; L = letture, S = scritture sul bus\n", STEPS);
+
+    // timer.c, ISR: *((int*)0x40000000) = ~(*((int*)0x40000000));
+    reset();
+    for (i = 0; i < STEPS; i++) {
+        OLD_WR(&reg_old, ~OLD_RD(&reg_old));
+        gpio_sh_toggle(&sh, 0xFFFFFFFF);
+        same("LED lampeggio (timer)", i);
+    }
+    report("LED lampeggio (timer)");
+
+    // interrupts.c, tasto: *gpio_0_data |= 0x1; (e 0x2 dal tasto esterno)
+    reset();
+    for (i = 0; i < STEPS; i++) {
+        mask = (i & 1) ? 0x2 : 0x1;
+        OLD_WR(&reg_old, OLD_RD(&reg_old) | mask);
+        gpio_sh_set(&sh, mask);
+        same("LED tasto (interrupts)", i);
+    }
+    report("LED tasto (interrupts)");
+
+    // Rover.c, frecce: *leds_data = (blink_state) ? 0x1 : 0x0;
+    reset();
+    for (i = 0; i < STEPS; i++) {
+        mask = (i & 1) ? 0x1 : 0x0;
+        OLD_WR(&reg_old, mask);
+        gpio_sh_write(&sh, mask);
+        same("LED frecce (rover)", i);
+    }
+    report("LED frecce (rover)");
+
+    // IER nell'immagine unica: ogni init accende le sue linee, il cambio
+    // le spegne tutte. Senza ombra: *IER |= mask; e *IER = 0;
+    reset();
+    for (i = 0; i < STEPS; i++) {
+        mask = 1u << (i % 6);
+        OLD_WR(&reg_old, 0);
+        gpio_sh_write(&sh, 0);
+        OLD_WR(&reg_old, OLD_RD(&reg_old) | mask);
+        gpio_sh_set(&sh, mask);
+        if (i % 3 == 0) {                   // Modulo con due linee
+            OLD_WR(&reg_old, OLD_RD(&reg_old) | (mask << 8));
+            gpio_sh_set(&sh, mask << 8);
+        }
+        same("IER cambio modulo (core)", i);
+    }
+    report("IER cambio modulo (core)");
+
+    printf(fails ? "%d controlli FAIL\n" : "Tutti gli scenari OK\n", fails);
+    return fails ? 1 : 0;
+}
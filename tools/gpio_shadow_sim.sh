@@ -0,0 +1,23 @@
+#!/bin/sh
+# Prova al banco dei registri ombra (tools/gpio_shadow_sim.c).
+# Compila gpio_shadow.h con il cc del PC, senza BSP, e confronta gli
+# accessi al bus di LED e IER con il codice di prima: uscita 1 se l'ombra
+# legge il registro, fa più scritture o lascia un valore diverso.
+#
+# Uso:
+#   tools/gpio_shadow_sim.sh
+#
+# Variabili: HOST_CC (default cc).
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT="${OUT:-$ROOT/_sim_build}"
+HOST_CC="${HOST_CC:-cc}"
+
+# xil_types.h e mb_interface.h vuoti: li sostituisce la prova
+mkdir -p "$OUT/inc"
+: > "$OUT/inc/xil_types.h"
+: > "$OUT/inc/mb_interface.h"
+$HOST_CC -std=gnu99 -O2 -Wall -I"$ROOT" -I"$OUT/inc" "$ROOT/tools/gpio_shadow_sim.c" -o "$OUT/gpio_shadow_sim"
+"$OUT/gpio_shadow_sim"
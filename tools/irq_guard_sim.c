@@ -0,0 +1,127 @@
+// Prova al banco di irq_guard (irq_guard.h) senza scheda: un tasto che
+// rimbalza su un GPIO AXI simulato, che interrompe su entrambi i fronti.
+//
+// Il tempo avanza a passi di 10 us; il tick di riarmo gira ogni 1 ms come
+// in interrupts.c. Per ogni scenario (durata della pressione, rimbalzi per
+// fronte) il tasto viene premuto 10 volte e si controlla che gli eventi
+// accettati siano esattamente 10: né rimbalzi né rilasci contati. In
+// modalità DEBOUNCE anche gli interrupt presi devono essere 10: rimbalzi
+// e rilascio arrivano solo a sorgente mascherata.
+// In modalità RATE senza rimbalzi vale lo stesso (i rilasci sono scartati
+// leggendo il pin); con i rimbalzi il limitatore non è un antirimbalzo:
+// si controlla solo che ogni pressione dia almeno un evento e al massimo
+// RATE_MAX.
+//
+// Compilato da tools/irq_guard_sim.sh con il cc del PC: non usa il BSP.
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Tipi e base dei tempi finti al posto di xil_types.h (vuoto, dallo
+// script) e di timebase.h (saltato dalla guardia)
+#define XIL_TYPES_H
+#define TIMEBASE_H
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef int32_t  s32;
+typedef uint64_t u64;
+
+static u32 sim_now;     // Tick a 100 MHz
+static inline u32 timebase_now32(void) { return sim_now; }
+
+#include "irq_guard.c"
+
+#define TICKS_PER_US    100
+#define STEP_US         10
+#define POLL_US         1000        // Tick di riarmo (GUARD_TICK_CYCLES)
+#define QUIET_MS        20          // BUTTON_QUIET_MS
+#define RATE_MAX        4           // BUTTON_RATE_MAX
+#define PRESSES         10
+#define GAP_MS          400         // Tra un rilascio e la pressione successiva
+
+// Registri del GPIO: IPISR è toggle-on-write, la cella lo emula
+static int reg_ipier, reg_ipisr, reg_data;
+
+// Prima di chiamare il guard l'IPISR a 1 diventa 0x101: se il guard scrive
+// (1, per azzerarlo) il valore cambia e dopo la chiamata il bit va a zero
+static void tow_before(void) { if (reg_ipisr & 1) reg_ipisr = 0x101; }
+static void tow_after(void)  { reg_ipisr = (reg_ipisr == 0x101) ? 1 : 0; }
+
+// Livello del pin all'istante t (us) di una pressione lunga 'hold_ms' con
+// 'bounces' inversioni spurie ogni 100 us dopo ogni fronte
+static int pin_at(u32 t, u32 hold_ms, u32 bounces)
+{
+    u32 period = (hold_ms + GAP_MS) * 1000;
+    u32 ph = t % period;
+    u32 press = 0, release = hold_ms * 1000;
+    int level = (ph >= press && ph < release);
+    u32 since = (ph >= release) ? ph - release : ph - press;
+
+    if (t / period >= PRESSES)
+        return 0;
+    if (since < bounces * 100 && ((since / 100) & 1) == 0)
+        level = !level; // Rimbalzo: per 100 us il contatto torna indietro
+    return level;
+}
+
+static int run(irq_guard_mode_t mode, u32 hold_ms, u32 bounces)
+{
+    irq_guard_t g;
+    u32 t, end = PRESSES * (hold_ms + GAP_MS) * 1000;
+    int prev = 0, events = 0, ok;
+
+    reg_ipier = 1;
+    reg_ipisr = 0;
+    reg_data = 0;
+    sim_now = 0;
+    irq_guard_init(&g, &reg_ipier, &reg_ipisr, 0x1, &reg_data, 0x1, 0x0, mode,
+                   QUIET_MS * 1000 * TICKS_PER_US, RATE_MAX);
+
+    for (t = 0; t < end; t += STEP_US) {
+        sim_now = t * TICKS_PER_US;
+        reg_data = pin_at(t, hold_ms, bounces);
+        if (reg_data != prev)
+            reg_ipisr |= 1;     // Fronte di salita o di discesa
+        prev = reg_data;
+
+        if ((reg_ipisr & 1) && reg_ipier) {
+            tow_before();
+            events += irq_guard_on_irq(&g);
+            tow_after();
+        }
+        if (t % POLL_US == 0) {
+            tow_before();
+            irq_guard_poll(&g);
+            tow_after();
+        }
+    }
+
+    if (mode == IRQ_GUARD_DEBOUNCE)
+        ok = (events == PRESSES && g.irqs == PRESSES);
+    else if (bounces == 0)
+        ok = (events == PRESSES);
+    else
+        ok = (events >= PRESSES && events <= PRESSES * RATE_MAX);
+    printf("%-8s pressione %4u ms, rimbalzi %2u: eventi %2d, interrupt %3u, "
+           "soppressi %3u, rilasci %2u, limitati %2u  %s\n",
+           mode == IRQ_GUARD_DEBOUNCE ? "debounce" : "rate", (unsigned)hold_ms,
+           (unsigned)bounces, events, (unsigned)g.irqs, (unsigned)g.suppressed,
+           (unsigned)g.releases, (unsigned)g.throttled, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+int main(void)
+{
+    static const u32 holds[] = { 5, 15, 50, 300 };
+    static const u32 bounce[] = { 0, 3, 20 };
+    int m, h, b, fails = 0;
+
+    for (m = IRQ_GUARD_DEBOUNCE; m <= IRQ_GUARD_RATE; m++)
+        for (h = 0; h < 4; h++)
+            for (b = 0; b < 3; b++)
+                fails += !run((irq_guard_mode_t)m, holds[h], bounce[b]);
+
+    printf(fails ? "%d scenari FAIL\n" : "Tutti gli scenari OK\n", fails);
+    return fails ? 1 : 0;
+}
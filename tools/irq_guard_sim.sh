@@ -0,0 +1,21 @@
+#!/bin/sh
+# Prova al banco di irq_guard con rimbalzi simulati (tools/irq_guard_sim.c).
+# Compila il guard con il cc del PC, senza BSP, ed esegue gli scenari:
+# uscita 1 se un tasto non produce esattamente un evento per pressione.
+#
+# Uso:
+#   tools/irq_guard_sim.sh
+#
+# Variabili: HOST_CC (default cc).
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT="${OUT:-$ROOT/_sim_build}"
+HOST_CC="${HOST_CC:-cc}"
+
+# xil_types.h vuoto: i tipi li definisce la prova
+mkdir -p "$OUT/inc"
+: > "$OUT/inc/xil_types.h"
+$HOST_CC -std=gnu99 -O2 -Wall -I"$ROOT" -I"$OUT/inc" "$ROOT/tools/irq_guard_sim.c" -o "$OUT/irq_guard_sim"
+"$OUT/irq_guard_sim"
@@ -0,0 +1,165 @@
+#!/bin/sh
+# Rapporto di ingombro in memoria dei sei programmi e dell'immagine unica
+# (app_main.c con APP_SINGLE_IMAGE, tutti i programmi come moduli).
+#
+# Per ogni programma compila il sorgente e i moduli che include con
+# -fstack-usage, poi stampa:
+#   - text/data/bss per modulo e totale (mb-size)
+#   - lo stack di ogni funzione (file .su), il frame più grande e quello di myISR
+# e confronta i totali con tools/mem_baseline.txt: un valore cresciuto oltre
+# la baseline è una regressione (uscita 1).
+#
+# Uso:
+#   BSP_INCLUDE=<bsp>/include [APP_INCLUDE=<app>/src] tools/mem_report.sh            confronto
+#   BSP_INCLUDE=<bsp>/include [APP_INCLUDE=<app>/src] tools/mem_report.sh --update   riscrive la baseline
+#
+# Variabili: MB_PREFIX (default mb-), CFLAGS (default dalle opzioni di Vitis),
+#            BSP_INCLUDE (cartella include del BSP, obbligatoria),
+#            APP_INCLUDE (sorgenti dell'applicazione Vitis con platform.h,
+#            facoltativa: senza, si usa un platform.h con i soli prototipi,
+#            che basta per compilare).
+#
+# La baseline non è ancora nel repository: va generata con mb-gcc e le
+# CFLAGS della scheda (i numeri di un altro compilatore non valgono):
+#   1. BSP_INCLUDE=... tools/mem_report.sh --update
+#   2. controllare che la prima riga sia il mb-gcc di Vitis
+#   3. git add tools/mem_baseline.txt, in un commit da solo
+# Da lì, una modifica che la cambia apposta la riscrive con --update e la
+# include nello stesso commit.
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BASELINE="$ROOT/tools/mem_baseline.txt"
+OUT="${OUT:-$ROOT/_mem_build}"
+CC="${MB_PREFIX-mb-}gcc"
+SIZE="${MB_PREFIX-mb-}size"
+CFLAGS="${CFLAGS:--O2 -mlittle-endian -mcpu=v11.0 -mxl-soft-mul}"
+PROGRAMS="FSM PWM PWM&uart Rover interrupts timer"
+
+if [ -z "$BSP_INCLUDE" ]; then
+    echo "BSP_INCLUDE non impostata (cartella include del BSP)" >&2
+    exit 2
+fi
+
+UPDATE=0
+[ "$1" = "--update" ] && UPDATE=1
+
+# Moduli usati da un sorgente: ogni #include "x.h" (anche dentro altri
+# header) con un x.c accanto, seguito fino a chiusura.
+modules_of() {
+    todo="$1"
+    seen=""
+    mods=""
+    while [ -n "$todo" ]; do
+        set -- $todo
+        src=$1; shift; todo="$*"
+        for h in $(grep -o '#include "[^"]*\.h"' "$ROOT/$src" | sed 's/#include "\(.*\)"/\1/'); do
+            [ -f "$ROOT/$h" ] || continue
+            case " $seen " in *" $h "*) continue;; esac
+            seen="$seen $h"
+            todo="$todo $h"
+            m=${h%.h}
+            if [ -f "$ROOT/$m.c" ]; then
+                mods="$mods $m"
+                todo="$todo $m.c"
+            fi
+        done
+    done
+    echo $mods
+}
+
+rm -rf "$OUT"
+mkdir -p "$OUT"
+
+# platform.h non è nel BSP: senza l'applicazione Vitis bastano i prototipi
+if [ -z "$APP_INCLUDE" ]; then
+    APP_INCLUDE="$OUT/inc"
+    mkdir -p "$APP_INCLUDE"
+    printf 'void init_platform(void);\nvoid cleanup_platform(void);\n' > "$APP_INCLUDE/platform.h"
+fi
+NEW="$OUT/mem_baseline.txt"
+# I numeri valgono solo per lo stesso compilatore con le stesse opzioni
+TOOLCHAIN="# cc: $($CC --version | head -1) | cflags: $CFLAGS"
+echo "$TOOLCHAIN" > "$NEW"
+echo "# programma stack_max_frame stack_isr text data bss" >> "$NEW"
+
+for prog in $PROGRAMS image; do
+    dir="$OUT/$(echo "$prog" | tr '&' '_')"
+    mkdir -p "$dir"
+    if [ "$prog" = image ]; then
+        # Immagine unica: tutti i programmi più i moduli che usano
+        units="app_main"
+        for p in $PROGRAMS; do
+            units="$units $p $(modules_of "$p.c")"
+        done
+        units=$(echo $units | tr ' ' '\n' | sort -u)
+        defs="-DAPP_SINGLE_IMAGE"
+    else
+        units="$prog $(modules_of "$prog.c")"
+        defs=""
+    fi
+
+    echo "=== $prog"
+    for u in $units; do
+        obj="$dir/$(echo "$u" | tr '&' '_').o"
+        (cd "$dir" && $CC $CFLAGS $defs -fstack-usage -I"$ROOT" -I"$APP_INCLUDE" -I"$BSP_INCLUDE" -c "$ROOT/$u.c" -o "$obj")
+    done
+
+    # text/data/bss per modulo e totale
+    $SIZE -t "$dir"/*.o
+    set -- $($SIZE -t "$dir"/*.o | tail -1)
+    text=$1; data=$2; bss=$3
+
+    # Stack per funzione, dal frame più grande
+    cat "$dir"/*.su | sort -t"$(printf '\t')" -k2 -n -r | head -10
+    frame=$(cat "$dir"/*.su | cut -f2 | sort -n | tail -1)
+    isr=$(grep ':myISR' "$dir"/*.su | cut -f2 | head -1)
+
+    echo "$prog ${frame:-0} ${isr:-0} $text $data $bss" >> "$NEW"
+done
+
+if [ $UPDATE -eq 1 ]; then
+    cp "$NEW" "$BASELINE"
+    echo "Baseline scritta in $BASELINE"
+    exit 0
+fi
+
+# Senza una baseline confrontabile il controllo non può passare
+if [ ! -f "$BASELINE" ]; then
+    echo "Manca $BASELINE: crearla con --update" >&2
+    exit 2
+fi
+if [ "$(head -1 "$BASELINE")" != "$TOOLCHAIN" ]; then
+    echo "Baseline di un altro compilatore o di altre opzioni:" >&2
+    echo "  baseline: $(head -1 "$BASELINE")" >&2
+    echo "  ora:      $TOOLCHAIN" >&2
+    echo "Rigenerarla con --update prima di confrontare" >&2
+    exit 2
+fi
+
+# Confronto con la baseline: ogni colonna può solo restare uguale o scendere
+echo "=== Confronto con la baseline"
+status=0
+grep -v '^#' "$NEW" | while read -r prog frame isr text data bss; do
+    base=$(grep "^$prog " "$BASELINE" || true)
+    if [ -z "$base" ]; then
+        echo "$prog: assente nella baseline"
+        continue
+    fi
+    set -- $base
+    fail=""
+    [ "$frame" -gt "$2" ] && fail="$fail stack_max_frame $2->$frame"
+    [ "$isr"   -gt "$3" ] && fail="$fail stack_isr $3->$isr"
+    [ "$text"  -gt "$4" ] && fail="$fail text $4->$text"
+    [ "$data"  -gt "$5" ] && fail="$fail data $5->$data"
+    [ "$bss"   -gt "$6" ] && fail="$fail bss $6->$bss"
+    if [ -n "$fail" ]; then
+        echo "$prog: FAIL$fail"
+        echo fail >> "$OUT/failed"
+    else
+        echo "$prog: OK"
+    fi
+done
+[ -f "$OUT/failed" ] && status=1
+exit $status
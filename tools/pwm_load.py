@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# Carico della CPU del PWM software per frequenza e risoluzione, dai cicli
+# misurati della ISR (lo stesso calcolo di pwm_cfg_compute, pwm_cfg.h).
+#
+# I cicli della ISR si danno in uno di tre modi:
+#   --cycles N          caso peggiore letto con il comando 'p' sulla scheda
+#   --serial cattura    la cattura della seriale dopo 'p': si prende il
+#                       "max" della riga --probe (default "tick motori" per
+#                       il rover, altrimenti "myISR")
+#   --bench risultati   $OUT/bench_results.txt di tools/bench/bench.sh, caso
+#                       --case (default pwm.isr_tick), convertito in cicli
+#                       con il modello qui sotto
+#
+# Modello da istruzioni a cicli (solo per --bench), MicroBlaze a 5 stadi
+# con codice e dati in memoria locale (LMB):
+#   cicli = istr + salti presi x --branch-cycles + accessi AXI x --axi-cycles
+# --branch-cycles è il costo in più di un salto preso (default 2, salto con
+# delay slot dal manuale del MicroBlaze); --axi-cycles è la latenza di una
+# lettura o scrittura di registro attraverso l'interconnect e non ha
+# default: va misurata sulla scheda (per esempio con isr_prof attorno a
+# un ciclo di letture di un GPIO). Il banco conta le scritture e le letture
+# allo stesso modo; il modello le paga uguali.
+#
+# Uso:
+#   tools/pwm_load.py --cycles 150
+#   tools/pwm_load.py --serial cattura.txt --probe myISR
+#   tools/pwm_load.py --bench _bench_build/bench_results.txt --case rover.isr_tick --axi-cycles 9
+#
+# Stampa la tabella come il comando "W" ("--" dove la configurazione non
+# è valida) e, con --csv, la scrive anche in un file per un grafico.
+
+import argparse
+import os
+import re
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(__file__), ".."))
+
+
+def table_freq():
+    """Frequenze della tabella del carico: pwm_table_freq di pwm_cfg.c"""
+    with open(os.path.join(ROOT, "pwm_cfg.c")) as f:
+        m = re.search(r'pwm_table_freq\[\]\s*=\s*\{([^}]*)\}', f.read())
+    if not m:
+        sys.exit("pwm_cfg.c: manca pwm_table_freq")
+    return [int(x) for x in m.group(1).split(",") if x.strip()]
+
+
+def define(path, name):
+    with open(os.path.join(ROOT, path)) as f:
+        m = re.search(r'#define\s+%s\s+(\d+)' % name, f.read())
+    if not m:
+        sys.exit("%s: manca %s" % (path, name))
+    return int(m.group(1))
+
+
+def cycles_from_serial(path, probe):
+    found = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = re.match(r'\s*(.+?): n=\d+ cicli min \d+ media \d+ max (\d+)', line)
+            if m and m.group(1) == probe:
+                found = int(m.group(2))     # L'ultima stampa vince
+    if found is None:
+        sys.exit("%s: nessuna riga '%s: n=... max ...' (comando 'p' con ISR_PROFILE)" % (path, probe))
+    return found
+
+
+def cycles_from_bench(path, case, branch, axi):
+    with open(path) as f:
+        for line in f:
+            p = line.split()
+            if p and p[0] == case:
+                istr, rd, wr, br = int(p[4]), int(p[5]), int(p[6]), int(p[7])
+                return istr + br * branch + (rd + wr) * axi, (istr, br, rd + wr)
+    sys.exit("%s: manca il caso %s" % (path, case))
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--cycles", type=int)
+    src.add_argument("--serial")
+    src.add_argument("--bench")
+    ap.add_argument("--probe")
+    ap.add_argument("--case", default="pwm.isr_tick")
+    ap.add_argument("--branch-cycles", type=int, default=2)
+    ap.add_argument("--axi-cycles", type=int)
+    ap.add_argument("--csv")
+    args = ap.parse_args()
+
+    clk = define("pwm_cfg.h", "PWM_CLK_HZ")
+    bits_max = define("pwm_cfg.h", "PWM_BITS_MAX")
+    period_min = define("pwm_cfg.h", "PWM_PERIOD_MIN")
+    load_max = define("isr_budget.h", "PWM_LOAD_MAX_PCT")
+    bits_min = define("pwm_cfg.c", "PWM_TABLE_BITS_MIN")
+    freqs = table_freq()
+
+    if args.cycles is not None:
+        cycles = args.cycles
+        origin = "misurati sulla scheda"
+    elif args.serial:
+        probe = args.probe
+        if probe is None:
+            with open(args.serial, errors="replace") as f:
+                probe = "tick motori" if "tick motori:" in f.read() else "myISR"
+        cycles = cycles_from_serial(args.serial, probe)
+        origin = "'%s' da %s" % (probe, args.serial)
+    else:
+        if args.axi_cycles is None:
+            sys.exit("--bench vuole --axi-cycles (latenza AXI misurata sulla scheda)")
+        cycles, (istr, br, axi) = cycles_from_bench(args.bench, args.case, args.branch_cycles,
+                                                    args.axi_cycles)
+        origin = "%s: %d istr + %d salti x %d + %d AXI x %d" % (
+            args.case, istr, br, args.branch_cycles, axi, args.axi_cycles)
+    if cycles <= 0:
+        sys.exit("cicli della ISR non validi: %d" % cycles)
+
+    bits_range = range(bits_min, bits_max + 1)
+    rows = []
+    for freq in freqs:
+        row = []
+        for bits in bits_range:
+            # pwm_cfg_compute: stesse divisioni intere
+            if freq > (clk >> bits) // period_min:
+                row.append(None)
+                continue
+            period = clk // (freq << bits)
+            load = cycles * 100 // period
+            row.append(load if load <= load_max else None)
+        rows.append(row)
+
+    print("Carico %% della ISR (%d cicli, %s) per frequenza e bit, max %d%%"
+          % (cycles, origin, load_max))
+    print("Hz\t" + "\t".join(str(b) for b in bits_range))
+    for freq, row in zip(freqs, rows):
+        print("%d\t" % freq + "\t".join("--" if v is None else str(v) for v in row))
+
+    if args.csv:
+        with open(args.csv, "w") as f:
+            f.write("hz," + ",".join("bit%d" % b for b in bits_range) + "\n")
+            for freq, row in zip(freqs, rows):
+                f.write("%d," % freq + ",".join("" if v is None else str(v) for v in row) + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
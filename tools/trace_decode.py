@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+# Decoder dello scarico del registratore di volo (trace.h, comando "@t").
+#
+# Legge la cattura grezza della seriale (anche con testo prima e dopo),
+# cerca l'intestazione "TRC1" e stampa i record dal più vecchio come
+# sequenza temporale: istante in ms dal primo record, distanza dal
+# precedente, tipo ed evento decodificato. L'ultima riga dice quanto
+# prima dello scarico è arrivato l'ultimo record. Gli istanti sono già
+# scalati sul dispositivo (TRACE_TS_SHIFT): il clock nell'intestazione è
+# quello degli istanti, non quello della base dei tempi.
+#
+# Uso:
+#   tools/trace_decode.py cattura.bin
+#   tools/trace_decode.py < cattura.bin
+#
+# Per catturare, per esempio:  stty -F /dev/ttyUSB1 115200 raw
+#                              cat /dev/ttyUSB1 > cattura.bin   (poi "@t")
+
+import struct
+import sys
+
+MAGIC = b"TRC1"
+HEADER = struct.Struct("<4sHHIIII")
+RECORD = struct.Struct("<IBBH")
+
+# Deve restare allineato con i TR_* di trace.h (l'8 è libero)
+TR_KEY, TR_CMD, TR_CORE, TR_APP, TR_SETPOINT, TR_RGB, TR_TURN = range(1, 8)
+TR_BUTTON, TR_ERROR, TR_FREEZE = range(9, 12)
+
+ERRORS = {1: "overrun UART", 2: "coda DPC piena", 3: "init del modulo fallito"}
+TURN = {0: "dritto", 1: "sinistra", 2: "destra"}
+
+
+def char(v):
+    return repr(chr(v)) if 32 <= v < 127 else "0x%02x" % v
+
+
+def describe(t, a, b):
+    if t == TR_KEY:
+        if a == ord("w"):
+            return "tasto     'w' preset %d" % b
+        return "tasto     %s" % char(a)
+    if t == TR_CMD:
+        # L'indice è nella tabella dei comandi del modulo attivo (TR_APP)
+        return "comando   %d del modulo (%d argomenti)" % (a, b)
+    if t == TR_CORE:
+        return "nucleo    @%s" % chr(a)
+    if t == TR_APP:
+        return "modulo    %d %s" % (a, "ERRORE" if b else "ok")
+    if t == TR_SETPOINT:
+        l, dr, dl = b & 0xFF, (b >> 8) & 1, (b >> 9) & 1
+        return "setpoint  R %d L %d" % (a if dr else -a, l if dl else -l)
+    if t == TR_RGB:
+        return "colore    %d %d %d" % (a, b >> 8, b & 0xFF)
+    if t == TR_TURN:
+        return "frecce    %s -> %s" % (TURN.get(b, b), TURN.get(a, a))
+    if t == TR_BUTTON:
+        return "tasto     %d (pressione %d)" % (a, b)
+    if t == TR_ERROR:
+        return "ERRORE    %s (0x%04x)" % (ERRORS.get(a, "codice %d" % a), b)
+    if t == TR_FREEZE:
+        return "congelato (%s)" % ("guasto" if a else "comando")
+    return "tipo %d   a=%d b=%d" % (t, a, b)
+
+
+def decode(data):
+    pos = data.find(MAGIC)
+    if pos < 0:
+        sys.exit("intestazione %r non trovata" % MAGIC)
+    magic, rec_size, n, head, clk_hz, now, _ = HEADER.unpack_from(data, pos)
+    if rec_size != RECORD.size:
+        sys.exit("record da %d byte, atteso %d" % (rec_size, RECORD.size))
+    pos += HEADER.size
+    if len(data) < pos + n * rec_size:
+        sys.exit("scarico troncato: %d record attesi" % n)
+
+    print("%d record (%d scritti in totale, %d persi), clock %d Hz (passo %.2f us)"
+          % (n, head, head - n, clk_hz, 1e6 / clk_hz))
+    ticks_ms = clk_hz / 1000.0
+    t = 0        # Istante srotolato in tick
+    last = None
+    for i in range(n):
+        ts, typ, a, b = RECORD.unpack_from(data, pos + i * rec_size)
+        # Istante a 32 bit: tra due record si assume meno di un giro
+        delta = 0 if last is None else (ts - last) & 0xFFFFFFFF
+        t += delta
+        last = ts
+        print("%10.3f ms  +%9.3f  %s" % (t / ticks_ms, delta / ticks_ms, describe(typ, a, b)))
+    if last is not None:
+        print("ultimo record %.3f ms prima dello scarico" % (((now - last) & 0xFFFFFFFF) / ticks_ms))
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+    decode(data)
+
+
+if __name__ == "__main__":
+    main()
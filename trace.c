@@ -0,0 +1,95 @@
+#include "xparameters.h"
+#include "xuartlite_l.h"
+#include "trace.h"
+
+#ifndef SDT
+    #define UART_BASEADDR   XPAR_UARTLITE_0_BASEADDR
+#else
+    #define UART_BASEADDR   XPAR_XUARTLITE_0_BASEADDR
+#endif
+
+#define TRACE_MAGIC     "TRC1"
+
+trace_rec_t trace_buf[TRACE_SIZE];
+volatile u32 trace_head = 0;
+volatile u8 trace_frozen = 0;
+
+// Scrittura dal main: la ISR non può prendere la stessa cella
+void trace_log(u8 type, u8 a, u16 b)
+{
+    u32 msr;
+
+    if (trace_frozen) return;
+    msr = mfmsr();
+    microblaze_disable_interrupts();
+    trace_log_isr(type, a, b);
+    mtmsr(msr);
+}
+
+// Congela il buffer: l'ultimo record dice perché
+void trace_freeze(u8 cause)
+{
+    trace_log(TR_FREEZE, cause, 0);
+    trace_frozen = 1;
+}
+
+void trace_resume(void)
+{
+    trace_frozen = 0;
+}
+
+void trace_fault(u8 code, u16 detail)
+{
+    trace_log(TR_ERROR, code, detail);
+    trace_freeze(1);
+}
+
+// --- SCARICO BINARIO ---
+static void trace_put8(u8 v)
+{
+    XUartLite_SendByte(UART_BASEADDR, v);
+}
+
+static void trace_put16(u16 v)
+{
+    trace_put8((u8)v);
+    trace_put8((u8)(v >> 8));
+}
+
+static void trace_put32(u32 v)
+{
+    trace_put16((u16)v);
+    trace_put16((u16)(v >> 16));
+}
+
+// Congela e invia intestazione e record dal più vecchio. Bloccante
+// (~2 KB a 115200 baud, circa 200 ms): gli interrupt restano attivi,
+// ma con il buffer congelato nessuno lo tocca.
+void trace_dump(void)
+{
+    const char *m = TRACE_MAGIC;
+    u32 head, n, i;
+
+    if (!trace_frozen)
+        trace_freeze(0);
+
+    head = trace_head;
+    n = (head < TRACE_SIZE) ? head : TRACE_SIZE;
+
+    while (*m)
+        trace_put8((u8)*m++);
+    trace_put16(sizeof(trace_rec_t));
+    trace_put16((u16)n);
+    trace_put32(head);
+    trace_put32((u32)(TIMEBASE_CLK_HZ >> TRACE_TS_SHIFT));
+    trace_put32(trace_now());
+    trace_put32(0);
+
+    for (i = head - n; i != head; i++) {
+        const trace_rec_t *r = &trace_buf[i & (TRACE_SIZE - 1)];
+        trace_put32(r->ts);
+        trace_put8(r->type);
+        trace_put8(r->a);
+        trace_put16(r->b);
+    }
+}
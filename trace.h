@@ -0,0 +1,105 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "xil_types.h"
+#include "mb_interface.h"
+#include "timebase.h"
+
+// --- REGISTRATORE DI VOLO (trace in RAM) ---
+// Un buffer circolare di eventi compatti con il loro istante: tasti e
+// comandi eseguiti, setpoint applicati, pressioni dei pulsanti, errori.
+// Quando il buffer è pieno i record più vecchi vengono sovrascritti,
+// quindi c'è sempre la storia più recente. Solo eventi rari: niente
+// record per byte ricevuto né per scadenza di un timer periodico, che in
+// pochi secondi coprirebbero tutto il resto.
+//
+// Scrivere un record costa una lettura a 64 bit della base dei tempi (tre
+// accessi al bus) e quattro scritture in RAM:
+//   trace_log_isr()  dalla ISR (sul MicroBlaze le ISR non si annidano)
+//                    o a interrupt già disabilitati;
+//   trace_log()      dal main: stessa cosa dentro una sezione critica
+//                    che salva e ripristina il MSR (una chiamata, per non
+//                    ripetere il codice a ogni punto di traccia).
+//
+// Un guasto (trace_fault) o il comando "@f" congelano il buffer: da lì
+// le scritture sono ignorate e la storia prima del guasto resta intatta.
+// "@t" lo congela e lo scarica in binario sulla seriale, "@r" riprende
+// la registrazione. tools/trace_decode.py trasforma lo scarico in una
+// sequenza temporale leggibile.
+//
+// Formato dello scarico (little-endian):
+//   "TRC1", u16 dimensione del record (8), u16 record che seguono,
+//   u32 record scritti in totale, u32 clock degli istanti (Hz),
+//   u32 istante dello scarico, u32 riservato (0),
+//   poi i record dal più vecchio: u32 istante, u8 tipo, u8 a, u16 b.
+// L'istante è la base dei tempi divisa per 2^TRACE_TS_SHIFT: a 100 MHz
+// un passo di ~10 us e un giro ogni ~12 ore, così anche record distanti
+// minuti restano ordinati. Il clock nell'intestazione è già diviso
+// (TIMEBASE_CLK_HZ >> TRACE_TS_SHIFT); il decoder srotola gli istanti
+// assumendo che tra due record consecutivi passi meno di un giro.
+
+#ifndef TRACE_SIZE
+#define TRACE_SIZE      256     // Record, deve essere una potenza di 2 (8 byte l'uno)
+#endif
+
+#define TRACE_TS_SHIFT  10      // Istante = tick della base dei tempi >> 10
+
+// Tipi di record: i valori sono anche in tools/trace_decode.py
+#define TR_KEY          1   // Tasto eseguito dal modulo         a = tasto, b = preset di "w<n>"
+#define TR_CMD          2   // Comando a parole eseguito         a = indice nella tabella, b = argomenti
+#define TR_CORE         3   // Comando del nucleo ("@x")         a = lettera
+#define TR_APP          4   // Cambio di modulo                  a = indice, b = 0 ok / 1 errore
+#define TR_SETPOINT     5   // Setpoint dei motori               a = velocità R, b = L | dir R << 8 | dir L << 9
+#define TR_RGB          6   // Colore chiesto                    a = R, b = G << 8 | B
+#define TR_TURN         7   // Cambio di stato delle frecce      a = nuovo, b = vecchio
+// 8 libero: niente record per le scadenze dei timer (vedi sopra)
+#define TR_BUTTON       9   // Pressione accettata               a = tasto, b = pressioni
+#define TR_ERROR        10  // Errore                            a = codice, b = dettaglio
+#define TR_FREEZE       11  // Buffer congelato                  a = 0 comando / 1 guasto
+
+// Codici di TR_ERROR
+#define TR_ERR_UART_OVERRUN 1   // Byte persi in ricezione
+#define TR_ERR_DPC_FULL     2   // Lavoro differito perso (coda piena)
+#define TR_ERR_APP_INIT     3   // Init di un modulo fallito
+
+typedef struct {
+    u32 ts;             // trace_now()
+    u8  type;
+    u8  a;
+    u16 b;
+} trace_rec_t;
+
+extern trace_rec_t trace_buf[TRACE_SIZE];
+extern volatile u32 trace_head;     // Record scritti in totale
+extern volatile u8 trace_frozen;
+
+// Istante di un record: il contatore a 64 bit scalato
+static inline u32 trace_now(void)
+{
+    return (u32)(timebase_now() >> TRACE_TS_SHIFT);
+}
+
+// Scrittura a interrupt disabilitati (ISR)
+static inline void trace_log_isr(u8 type, u8 a, u16 b)
+{
+    u32 h;
+    trace_rec_t *r;
+
+    if (trace_frozen) return;
+    h = trace_head;
+    r = &trace_buf[h & (TRACE_SIZE - 1)];
+    r->ts = trace_now();
+    r->type = type;
+    r->a = a;
+    r->b = b;
+    trace_head = h + 1;
+}
+
+// Prototipi
+void trace_log(u8 type, u8 a, u16 b);   // Dal main (non inline: il codice non è caldo)
+void trace_freeze(u8 cause);
+void trace_resume(void);
+void trace_fault(u8 code, u16 detail);  // Registra l'errore e congela (main o ISR)
+void trace_dump(void);
+
+#endif